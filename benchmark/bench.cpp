@@ -0,0 +1,225 @@
+/**
+ *      @file benchmark/bench.cpp
+ *      @brief benchmark driver run by `make bench`, times every phase of the interpeter on generated workloads and prints the results as JSON
+ *      @author Anastasia Sokol
+ *
+ *      usage: benchmark/bench [--scale N] [--workload NAME]
+ *          --scale N multiplies the size of every workload (default 1)
+ *          --workload NAME only runs the named workload (may be repeated)
+ *
+ *      phases are measured separately by materializing the output of each one before starting the next
+ *          lex: LexStream into a vector of tokens
+ *          block_parse: BlockStream over those tokens into a vector of blocks
+ *          expression_build: ExpressionStream over those blocks, followed by constant folding (same as main.cpp)
+ *          eval_tree and eval_vm: running every expression with each engine in a fresh ProgramState (eval_vm includes compiling to bytecode)
+**/
+
+#include "../lexer/lexstream.hpp"           // defines lexer::LexStream used for the lex phase
+#include "../parser/blockstream.hpp"        // defines parser::BlockStream used for the block_parse phase
+#include "../parser/expressionstream.hpp"   // defines parser::ExpressionStream used for the expression_build phase
+#include "../vm/compiler.h"                 // defines vm::Compiler used for the eval_vm phase
+#include "../vm/machine.h"                  // defines vm::Machine used for the eval_vm phase
+
+#include <algorithm>                        // defines std::find used to select workloads
+#include <chrono>                           // defines std::chrono::steady_clock used for timing
+#include <exception>                        // defines std::exception used to report failures
+#include <filesystem>                       // defines std::filesystem used to locate the temporary directory
+#include <fstream>                          // defines std::ofstream used to write generated workloads
+#include <functional>                       // defines std::function used to store workload generators
+#include <optional>                         // defines std::optional used to keep the lexer alive after the lex phase
+#include <sstream>                          // defines std::ostringstream used to generate workloads
+#include <string>                           // defines std::string used for names and sources
+#include <vector>                           // defines std::vector used to hold the output of each phase
+
+#include <cstdio>                           // defines std::printf used to emit results
+#include <cstdlib>                          // defines std::atoi, EXIT_SUCCESS, and EXIT_FAILURE
+#include <cstring>                          // defines std::strcmp used to read command line options
+
+namespace {
+
+/**
+ *  @brief a generated program, parameter is already multiplied by the scale
+**/
+struct Workload {
+    const char *name;                                       // name used in output and with --workload
+    long base;                                              // size of workload at scale 1
+    std::function<std::string(long)> generate;              // produce source for a given size
+};
+
+const std::vector<Workload> workloads = {
+    {"fib", 4, [](long count){
+        // deep (non tail) recursion, count independent calls to fib 16
+        std::ostringstream source;
+        source << "(define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))\n";
+        for(long i = 0; i < count; ++i){
+            source << "(define result (fib 16))\n";
+        }
+        return source.str();
+    }},
+    {"factorial", 200, [](long count){
+        // deep recursion, count calls to factorial 400
+        std::ostringstream source;
+        source << "(define factorial (lambda (n) (if (<= n 1) 1 (* n (factorial (- n 1))))))\n";
+        for(long i = 0; i < count; ++i){
+            source << "(define result (factorial 400))\n";
+        }
+        return source.str();
+    }},
+    {"operator_chain", 2000, [](long width){
+        // a single operator with width arguments (references so that nothing folds), evaluated 200 times
+        std::ostringstream source;
+        source << "(define x 1)\n(define wide (lambda () (+";
+        for(long i = 0; i < width; ++i){
+            source << " x";
+        }
+        source << ")))\n";
+        source << "(define repeat (lambda (n) (if (<= n 0) 0 ((lambda (ignored) (repeat (- n 1))) (wide)))))\n";
+        source << "(define result (repeat 200))\n";
+        return source.str();
+    }},
+    {"string_concat", 2000, [](long length){
+        // append to a string length times
+        std::ostringstream source;
+        source << "(define build (lambda (n text) (if (<= n 0) text (build (- n 1) (+ text \"ab\")))))\n";
+        source << "(define result (build " << length << " \"\"))\n";
+        return source.str();
+    }},
+    {"lazy_composition", 200, [](long depth){
+        // compose a function with lazy operators depth times, then call it 50 times
+        std::ostringstream source;
+        source << "(define f (lambda (x) (* x x)))\n";
+        source << "(define compose (lambda (n g) (if (<= n 0) g (compose (- n 1) (+ g 1)))))\n";
+        source << "(define composed (compose " << depth << " f))\n";
+        source << "(define repeat (lambda (n) (if (<= n 0) 0 ((lambda (ignored) (repeat (- n 1))) (composed 3)))))\n";
+        source << "(define result (repeat 50))\n";
+        return source.str();
+    }},
+    {"define_list", 20000, [](long count){
+        // a huge number of top level defines
+        std::ostringstream source;
+        for(long i = 0; i < count; ++i){
+            source << "(define value" << i << " (+ " << i << " (* 2 3) \"text\"))\n";
+        }
+        return source.str();
+    }}
+};
+
+/**
+ *  @brief time a single call
+ *  @return seconds taken
+**/
+template <typename function_t>
+double time(function_t function){
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ *  @brief run every phase on a single workload and print its JSON object
+**/
+void run(const Workload &workload, long scale, bool first){
+    const long parameter = workload.base * scale;
+    const std::string source = workload.generate(parameter);
+
+    const std::filesystem::path filepath = std::filesystem::temp_directory_path() / (std::string("fragment_bench_") + workload.name + ".fr");
+    {
+        std::ofstream output(filepath);
+        output << source;
+    }
+
+    // lex, the iterator owns the text every token refers to so it has to outlive the other phases
+    lexer::LexStream lexstream(filepath.c_str());
+    std::vector<Token> tokens;
+    std::optional<lexer::LexStream::LexStreamIterator> lexer;
+    const double lex = time([&](){
+        lexer.emplace(lexstream.begin());
+        for(; *lexer != lexstream.end(); ++*lexer){
+            tokens.push_back(**lexer);
+        }
+        tokens.push_back(**lexer);  // keep end of file token so BlockStream knows where to stop
+    });
+
+    // block parse
+    std::vector<Block> blocks;
+    const double block_parse = time([&](){
+        parser::BlockStream<std::vector<Token>&> stream(tokens);
+        for(const Block &block : stream){
+            blocks.push_back(block);
+        }
+    });
+
+    // expression build
+    std::vector<Expression::expression_t> expressions;
+    const double expression_build = time([&](){
+        for(Expression::expression_t expression : parser::ExpressionStream<std::vector<Block>&>(blocks)){
+            Expression::optimize(expression);
+            expressions.push_back(std::move(expression));
+        }
+    });
+
+    // evaluate
+    const double eval_tree = time([&](){
+        ProgramState state;
+        for(const auto &expression : expressions){
+            (*expression)(state);
+        }
+    });
+
+    const double eval_vm = time([&](){
+        ProgramState state;
+        vm::Machine machine(state);
+        for(const auto &expression : expressions){
+            machine.run(vm::Compiler::compile(*expression));
+        }
+    });
+
+    std::filesystem::remove(filepath);
+
+    std::printf("%s\n    {\"name\": \"%s\", \"parameter\": %ld, \"bytes\": %zu, \"tokens\": %zu, \"expressions\": %zu, \"seconds\": {\"lex\": %.6f, \"block_parse\": %.6f, \"expression_build\": %.6f, \"eval_tree\": %.6f, \"eval_vm\": %.6f}}",
+        first ? "" : ",", workload.name, parameter, source.size(), tokens.size(), expressions.size(), lex, block_parse, expression_build, eval_tree, eval_vm);
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char **argv){
+    long scale = 1;
+    std::vector<std::string> selected;
+
+    for(int i = 1; i < argc; ++i){
+        if(!std::strcmp(argv[i], "--scale") && i + 1 < argc){
+            scale = std::atol(argv[++i]);
+        } else if(!std::strcmp(argv[i], "--workload") && i + 1 < argc){
+            selected.push_back(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--scale N] [--workload NAME]...\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(scale < 1){
+        std::fprintf(stderr, "scale must be a positive integer\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("{\"scale\": %ld, \"workloads\": [", scale);
+
+    bool first = true;
+    for(const Workload &workload : workloads){
+        if(!selected.empty() && std::find(selected.begin(), selected.end(), workload.name) == selected.end()){
+            continue;
+        }
+
+        try {
+            run(workload, scale, first);
+            first = false;
+        } catch(const std::exception &error){
+            std::fprintf(stderr, "workload %s failed: %s\n", workload.name, error.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::printf("\n]}\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/**
+ *      @file benchmark/classifier.cpp
+ *      @brief measures token classification throughput (tokens/sec) of lexer::classify against the previous set based lookup
+ *      @author Anastasia Sokol
+**/
+
+#include "../lexer/classifier.hpp"  // defines lexer::classify which is being measured
+
+#include <algorithm>                // defines std::any_of used by the previous implementation
+#include <chrono>                   // defines std::chrono::steady_clock used for timing
+#include <string>                   // defines std::string used by the previous implementation
+#include <string_view>              // defines std::string_view used to refer to lexemes
+#include <vector>                   // defines std::vector used to hold the input lexemes
+
+#include <cctype>                   // defines std::isdigit used by the previous implementation
+#include <cstdint>                  // defines std::int8_t used by the previous implementation
+#include <cstdio>                   // defines std::printf used to report results
+
+namespace {
+
+/**
+ *  @brief classification as it was done before lexer::classify, kept only for comparison
+**/
+Token::TokenType classify_with_sets(const std::string value){
+    const auto in_set = [value](std::vector<const char*> set) -> bool { return std::any_of(set.begin(), set.end(), [value](auto x) -> bool { return value == x; }); };
+
+    if(in_set({"(", ")"})){
+        return Token::TokenType::delimiter;
+    } else if(value[0] == '"'){
+        return value[value.length() - 1] == '"' ? Token::TokenType::stringliteral : Token::TokenType::null;
+    } else if(std::isdigit(value[0])) {
+        std::int8_t allowed_decimals = 1;
+        return std::all_of(value.begin(), value.end(), [&allowed_decimals](char value) -> bool { return std::isdigit(value) || (value == '.' && !--allowed_decimals); }) ? Token::TokenType::numeric : Token::TokenType::null;
+    } else if(in_set({"true", "false"})) {
+        return Token::TokenType::boolean;
+    } else if(in_set({"define", "lambda", "if"})) {
+        return Token::TokenType::keyword;
+    } else if(in_set({"+", "-", "*", "/", ">", "<", "=", ">=", "<="})) {
+        return Token::TokenType::operation;
+    } else if(value == "%%") {
+        return Token::TokenType::comment;
+    }
+
+    return Token::TokenType::reference;
+}
+
+/**
+ *  @brief classify every lexeme repeatedly and print throughput
+**/
+template <typename classifier_t>
+void measure(const char* const name, const std::vector<std::string_view> &lexemes, classifier_t classifier){
+    constexpr int repetitions = 20000;
+
+    std::size_t checksum = 0;  // keeps the work from being optimized away
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < repetitions; ++i){
+        for(const std::string_view lexeme : lexemes){
+            checksum += (std::size_t)classifier(lexeme);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double tokens = (double)repetitions * lexemes.size();
+
+    std::printf("%-9s %12.0f tokens %8.3f s %14.0f tokens/sec (checksum %zu)\n", name, tokens, seconds, tokens / seconds, checksum);
+}
+
+} // end of anonymous namespace
+
+int main(){
+    // token mix taken from the factorial example
+    const std::vector<std::string_view> lexemes = {
+        "(", "define", "factorial", "(", "lambda", "(", "n", ")", "(", "if", "(", "<=", "n", "1", ")",
+        "(", "1", ")", "(", "*", "n", "(", "factorial", "(", "-", "n", "1", ")", ")", ")", ")", ")", ")",
+        "(", "define", "value", "8", ")", "(", "println", "value", "\"! = \"", "(", "factorial", "value", ")", ")",
+        "(", "%%", "comment", "%%", ")", "true", "false", "3.14159", "\"Hello World\""
+    };
+
+    measure("sets", lexemes, [](std::string_view lexeme){ return classify_with_sets(std::string(lexeme)); });
+    measure("classify", lexemes, [](std::string_view lexeme){ return lexer::classify(lexeme); });
+
+    return 0;
+}
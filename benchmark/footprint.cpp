@@ -0,0 +1,186 @@
+/**
+ *      @file benchmark/footprint.cpp
+ *      @brief measures how much memory values take, the size of every value type and the heap used per value while many of them are alive
+ *      @author Anastasia Sokol
+ *
+ *      heap use is read from glibc (mallinfo2) before and after filling a vector of handles, so it includes the vector, boxed values, and the blocks
+ *      the value pool took for them, the pool never gives blocks back so every kind of value is measured once, in a size class nothing else used yet
+ *      without glibc (2.33 or later) it is counted instead, from the handles and the pool blocks handed out for them, which leaves out anything values allocate themselves
+ *      given pmap as its argument it instead runs pmap over and over on four threads, the values workers make are freed by the caller, and prints
+ *      peak memory after every batch, which stays flat once blocks freed on one thread are reused by the others
+**/
+
+#include "../lexer/lexstream.hpp"           // defines lexer::LexStream used to read the pmap program
+#include "../parser/blockstream.hpp"        // defines parser::BlockStream used to read the pmap program
+#include "../parser/expressionstream.hpp"   // defines parser::ExpressionStream used to read the pmap program
+#include "../utility/parallel.h"            // defines frstd::pmap which is run repeatedly
+#include "../utility/threadpool.h"          // defines frstd::ThreadPool::participants used to run pmap on several threads
+#include "../value/booleanvalue.h"          // defines BooleanValue whose size is reported
+#include "../value/functionvalue.h"         // defines FunctionValue which is measured
+#include "../value/numericvalue.h"          // defines NumericValue whose size is reported
+#include "../value/stringvalue.h"           // defines StringValue which is measured
+#include "../value/valuepool.h"             // defines pool::statistics used to count chunks taken by pmap and blocks handed out without glibc
+
+#include <exception>                        // defines std::exception used to report failures
+#include <filesystem>                       // defines std::filesystem used to locate the temporary directory
+#include <fstream>                          // defines std::ofstream used to write the pmap program
+#include <string>                           // defines std::string and std::to_string used to build distinct strings
+#include <vector>                           // defines std::vector used to hold the values
+
+#include <cstddef>                          // defines std::size_t
+#include <cstdio>                           // defines std::printf used to report results
+#include <cstdlib>                          // defines EXIT_SUCCESS and EXIT_FAILURE
+#include <cstring>                          // defines std::strcmp used to read the argument
+
+// mallinfo2 was added in glibc 2.33, __GLIBC__ is defined by any C library header included above
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>                         // defines mallinfo2 used to read heap use
+#define FOOTPRINT_MALLINFO
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>                   // defines getrusage used to read peak memory
+#define FOOTPRINT_RUSAGE
+#endif
+
+namespace {
+
+using value_t = Value::value_t;
+
+/**
+ *  @brief get bytes of heap in use, including large blocks glibc maps on their own
+ *  @desc without glibc, bytes of pool blocks handed out so far instead
+**/
+std::size_t heap(){
+#ifdef FOOTPRINT_MALLINFO
+    const struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    std::size_t total = 0;
+    for(std::size_t index = 0; index < pool::classes; ++index){
+        total += pool::statistics(index).allocations * (index + 1) * pool::granularity;
+    }
+    return total;
+#endif
+}
+
+/**
+ *  @brief hold count values made by make at once and print the heap used per value
+**/
+template <typename make_t>
+void measure(const char* const name, std::size_t count, make_t make){
+    const std::size_t before = heap();
+    {
+        std::vector<value_t> values;
+        values.reserve(count);
+        for(std::size_t i = 0; i < count; ++i){
+            values.push_back(make(i));
+        }
+
+        const std::size_t during = heap();
+#ifdef FOOTPRINT_MALLINFO
+        std::printf("%-10s %10zu values %10.1f bytes/value\n", name, count, (double)(during - before) / count);
+#else
+        std::printf("%-10s %10zu values %10.1f bytes/value (handle and pool block only)\n", name, count, sizeof(value_t) + (double)(during - before) / count);
+#endif
+    }
+}
+
+/**
+ *  @brief get chunks the value pool took from the heap, for every size class
+**/
+unsigned long long chunks(){
+    unsigned long long total = 0;
+    for(std::size_t index = 0; index < pool::classes; ++index){
+        total += pool::statistics(index).chunks;
+    }
+    return total;
+}
+
+/**
+ *  @brief run pmap over and over, printing peak memory and chunks taken by the pool after every batch
+**/
+void repeat(){
+    constexpr int batches = 8;
+
+    const std::filesystem::path filepath = std::filesystem::temp_directory_path() / "fragment_footprint_pmap.fr";
+    {
+        std::ofstream output(filepath);
+        output << "(define run (lambda (n acc) (if (<= n 0) acc (run (- n 1) ((pmap (lambda (i) (+ \"x\" i)) 5000) 0)))))\n";
+        output << "(define result (run 100 0))\n";
+    }
+
+    std::vector<Expression::expression_t> expressions;
+    for(Expression::expression_t expression : parser::ExpressionStream(parser::BlockStream(lexer::LexStream(filepath.c_str())))){
+        Expression::optimize(expression);
+        expressions.push_back(std::move(expression));
+    }
+    std::filesystem::remove(filepath);
+
+    frstd::ThreadPool::participants = 4;
+
+    std::printf("%-10s %10s %10s\n", "pmap runs", "peak MB", "chunks");
+    ProgramState state;
+    state.set("pmap", value_t::make<FunctionValue>(frstd::pmap));
+    ProgramState::current = &state;
+
+    for(int batch = 1; batch <= batches; ++batch){
+        for(const auto &expression : expressions){
+            (*expression)(state);
+        }
+
+#ifdef FOOTPRINT_RUSAGE
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+        const double peak = usage.ru_maxrss / 1048576.0;
+    #else
+        const double peak = usage.ru_maxrss / 1024.0;
+    #endif
+        std::printf("%-10d %10.1f %10llu\n", batch * 100, peak, chunks());
+#else
+        std::printf("%-10d %10s %10llu\n", batch * 100, "-", chunks());
+#endif
+    }
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char **argv){
+    constexpr std::size_t count = 1000000;
+
+    // run on its own, the values measured below would set peak memory before pmap starts
+    if(argc > 1 && !std::strcmp(argv[1], "pmap")){
+        try {
+            repeat();
+        } catch(const std::exception &error){
+            std::fprintf(stderr, "Benchmark failed: %s\n", error.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    std::printf("%-24s %6s\n", "type", "bytes");
+    std::printf("%-24s %6zu\n", "Value::value_t", sizeof(value_t));
+    std::printf("%-24s %6zu\n", "Value", sizeof(Value));
+    std::printf("%-24s %6zu\n", "NumericValue", sizeof(NumericValue));
+    std::printf("%-24s %6zu\n", "BooleanValue", sizeof(BooleanValue));
+    std::printf("%-24s %6zu\n", "StringValue", sizeof(StringValue));
+    std::printf("%-24s %6zu\n", "FunctionValue", sizeof(FunctionValue));
+    std::printf("%-24s %6zu\n", "Value::function_t", sizeof(Value::function_t));
+    std::printf("\n");
+
+    // numerics and booleans are never boxed, all they take is the handle
+    measure("numeric", count, [](std::size_t i){ return value_t((double)i); });
+    measure("boolean", count, [](std::size_t i){ return value_t(i % 2 == 0); });
+
+    // short enough to be stored inside std::string, so only the boxed value is allocated
+    measure("string", count, [](std::size_t i){ return value_t::make<StringValue>(std::to_string(i)); });
+
+    // small enough to be stored inside std::function, so only the boxed value is allocated
+    measure("function", count, [](std::size_t i){
+        return value_t::make<FunctionValue>([i](const Value::arguments_t&){ return value_t((double)i); });
+    });
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+/**
+ *      @file benchmark/lexer.cpp
+ *      @brief measures lexer throughput (MB/s) for each lexer::LexStream::SourceMode
+ *      @author Anastasia Sokol
+ *
+ *      usage: benchmark/lexer [input file]
+ *      if no input file is given a large synthetic program is generated in the temporary directory
+**/
+
+#include "../lexer/lexstream.hpp"   // defines lexer::LexStream which is being measured
+#include "sample.hpp"               // defines benchmark::sample used to generate input
+
+#include <chrono>                   // defines std::chrono::steady_clock used for timing
+#include <exception>                // defines std::exception used to report failures
+#include <filesystem>               // defines std::filesystem used to locate temporary directory and file size
+#include <fstream>                  // defines std::ofstream used to write generated input
+#include <string>                   // defines std::string used for file paths
+
+#include <cstdint>                  // defines std::uintmax_t used for file sizes
+#include <cstdio>                   // defines std::printf used to report results
+#include <cstdlib>                  // defines EXIT_SUCCESS and EXIT_FAILURE
+
+namespace {
+
+/**
+ *  @brief lex the whole file once
+ *  @return number of tokens read
+**/
+std::size_t lex(const char* const filepath, lexer::LexStream::SourceMode mode){
+    lexer::LexStream stream(filepath, mode);
+    std::size_t count = 0;
+    for(auto it = stream.begin(); it != stream.end(); ++it){
+        ++count;
+    }
+    return count;
+}
+
+/**
+ *  @brief time lexing in the given mode and print throughput
+**/
+void measure(const char* const name, const char* const filepath, lexer::LexStream::SourceMode mode, std::uintmax_t bytes){
+    constexpr int repetitions = 3;
+
+    std::size_t tokens = 0;
+    double best = 0;
+    for(int i = 0; i < repetitions; ++i){
+        const auto start = std::chrono::steady_clock::now();
+        tokens = lex(filepath, mode);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(!i || seconds < best){
+            best = seconds;
+        }
+    }
+
+    std::printf("%-9s %10zu tokens %8.3f s %9.1f MB/s\n", name, tokens, best, bytes / best / 1e6);
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char **argv){
+    std::filesystem::path filepath;
+    bool generated = false;
+
+    if(argc > 1){
+        filepath = argv[1];
+    } else {
+        filepath = std::filesystem::temp_directory_path() / "fragment_lexer_benchmark.fr";
+        std::ofstream output(filepath);
+        for(int i = 0; i < 20000; ++i){
+            output << benchmark::sample;
+        }
+        generated = true;
+    }
+
+    int status = EXIT_SUCCESS;
+
+    try {
+        const std::uintmax_t bytes = std::filesystem::file_size(filepath);
+        std::printf("input: %s (%ju bytes)\n", filepath.c_str(), bytes);
+        measure("buffered", filepath.c_str(), lexer::LexStream::SourceMode::buffered, bytes);
+        measure("streamed", filepath.c_str(), lexer::LexStream::SourceMode::streamed, bytes);
+    } catch(const std::exception &error){
+        std::fprintf(stderr, "Benchmark failed: %s\n", error.what());
+        status = EXIT_FAILURE;
+    }
+
+    if(generated){
+        std::filesystem::remove(filepath);
+    }
+
+    return status;
+}
@@ -0,0 +1,82 @@
+/**
+ *      @file benchmark/numeric.cpp
+ *      @brief measures numeric formatting and parsing throughput (numbers/sec) of NumericValue::format and NumericValue::parse against the stringstream and std::stod path they replaced
+ *      @author Anastasia Sokol
+**/
+
+#include "../value/numericvalue.h"  // defines NumericValue::format and NumericValue::parse which are being measured
+
+#include <chrono>                   // defines std::chrono::steady_clock used for timing
+#include <iomanip>                  // defines std::setprecision used by the previous implementation
+#include <sstream>                  // defines std::stringstream used by the previous implementation
+#include <string>                   // defines std::string, std::to_string, and std::stod
+#include <string_view>              // defines std::string_view used to pass text to parse
+#include <vector>                   // defines std::vector used to hold the inputs
+
+#include <cmath>                    // defines std::modf used by the previous implementation
+#include <cstdio>                   // defines std::printf used to report results
+
+namespace {
+
+/**
+ *  @brief formatting as it was done before NumericValue::format, kept only for comparison
+**/
+std::string format_with_streams(double value){
+    double integral;
+    if(std::modf(value, &integral) == 0.0){
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(0) << integral;
+        return ss.str();
+    } else {
+        return std::to_string(value);
+    }
+}
+
+/**
+ *  @brief run operation over every input repeatedly and print throughput
+**/
+template <typename input_t, typename operation_t>
+void measure(const char* const name, const std::vector<input_t> &inputs, operation_t operation){
+    constexpr int repetitions = 200;
+
+    double checksum = 0;  // keeps the work from being optimized away
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < repetitions; ++i){
+        for(const input_t &input : inputs){
+            checksum += operation(input);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double count = (double)repetitions * inputs.size();
+
+    std::printf("%-14s %12.0f numbers %8.3f s %14.0f numbers/sec (checksum %.0f)\n", name, count, seconds, count / seconds, checksum);
+}
+
+} // end of anonymous namespace
+
+int main(){
+    // whole numbers are by far the most common (counters, indices, lengths), then a few fractions
+    std::vector<double> numbers;
+    for(int i = 0; i < 10000; ++i){
+        numbers.push_back(i * 37 % 100003);
+        if(i % 4 == 0){
+            numbers.push_back(i / 7.0);
+        }
+    }
+
+    std::vector<std::string> texts;
+    for(const double number : numbers){
+        texts.push_back(format_with_streams(number));
+    }
+
+    measure("format streams", numbers, [](double number){ return (double)format_with_streams(number).size(); });
+    measure("format", numbers, [](double number){
+        char buffer[NumericValue::format_capacity];
+        return (double)NumericValue::format(number, buffer);
+    });
+
+    measure("parse stod", texts, [](const std::string &text){ return std::stod(text); });
+    measure("parse", texts, [](const std::string &text){ return NumericValue::parse(text); });
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ *      @file benchmark/parser.cpp
+ *      @brief measures parse time of the staged (BlockStream then ExpressionStream) and fused (FusedExpressionStream) pipelines
+ *      @author Anastasia Sokol
+ *
+ *      usage: benchmark/parser [input file]
+ *      if no input file is given a large synthetic program is generated in the temporary directory
+ *      expressions are only built, never evaluated
+**/
+
+#include "../lexer/lexstream.hpp"                   // defines lexer::LexStream which provides tokens for both pipelines
+#include "../parser/blockstream.hpp"                // defines parser::BlockStream used by the staged pipeline
+#include "../parser/expressionstream.hpp"           // defines parser::ExpressionStream used by the staged pipeline
+#include "../parser/fusedexpressionstream.hpp"      // defines parser::FusedExpressionStream which is the fused pipeline
+#include "sample.hpp"                               // defines benchmark::sample used to generate input
+
+#include <chrono>                                   // defines std::chrono::steady_clock used for timing
+#include <cstdint>                                  // defines std::uintmax_t used for file sizes
+#include <exception>                                // defines std::exception used to report failures
+#include <filesystem>                               // defines std::filesystem used to locate temporary directory and file size
+#include <fstream>                                  // defines std::ofstream used to write generated input
+
+#include <cstdio>                                   // defines std::printf used to report results
+#include <cstdlib>                                  // defines EXIT_SUCCESS and EXIT_FAILURE
+
+namespace {
+
+/**
+ *  @brief build every expression in a stream
+ *  @return number of top level expressions
+**/
+template <typename stream_t>
+std::size_t parse(stream_t &&stream){
+    std::size_t count = 0;
+    for(const auto &expression : stream){
+        count += (bool)expression;
+    }
+    return count;
+}
+
+/**
+ *  @brief time parsing with the given pipeline and print throughput
+**/
+template <typename pipeline_t>
+void measure(const char* const name, pipeline_t pipeline, std::uintmax_t bytes){
+    constexpr int repetitions = 3;
+
+    std::size_t expressions = 0;
+    double best = 0;
+    for(int i = 0; i < repetitions; ++i){
+        const auto start = std::chrono::steady_clock::now();
+        expressions = pipeline();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(!i || seconds < best){
+            best = seconds;
+        }
+    }
+
+    std::printf("%-7s %8zu expressions %8.3f s %9.1f MB/s %12.0f expressions/sec\n", name, expressions, best, bytes / best / 1e6, expressions / best);
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char **argv){
+    std::filesystem::path filepath;
+    bool generated = false;
+
+    if(argc > 1){
+        filepath = argv[1];
+    } else {
+        filepath = std::filesystem::temp_directory_path() / "fragment_parser_benchmark.fr";
+        std::ofstream output(filepath);
+        for(int i = 0; i < 10000; ++i){
+            output << benchmark::sample;
+        }
+        generated = true;
+    }
+
+    int status = EXIT_SUCCESS;
+
+    try {
+        const char* const path = filepath.c_str();
+        const std::uintmax_t bytes = std::filesystem::file_size(filepath);
+        std::printf("input: %s (%ju bytes)\n", path, bytes);
+        measure("staged", [path](){ return parse(parser::ExpressionStream(parser::BlockStream(lexer::LexStream(path)))); }, bytes);
+        measure("fused", [path](){ return parse(parser::FusedExpressionStream(lexer::LexStream(path))); }, bytes);
+    } catch(const std::exception &error){
+        std::fprintf(stderr, "Benchmark failed: %s\n", error.what());
+        status = EXIT_FAILURE;
+    }
+
+    if(generated){
+        std::filesystem::remove(filepath);
+    }
+
+    return status;
+}
@@ -0,0 +1,173 @@
+/**
+ *      @file benchmark/refcount.cpp
+ *      @brief measures what reference counting costs recursive programs, comparing counts updated without atomic instructions (single threaded runs) with atomic ones
+ *      @author Anastasia Sokol
+ *
+ *      every workload is parsed once and then run by both engines, first with plain counts and then again after RefCounted::share
+ *      made every count atomic (as it is once pmap, preduce, or --pipeline start a thread), so the difference is the refcount traffic saved
+ *      also copies a single handle in a loop, next to the std::shared_ptr values and expressions used to be held by (which libstdc++ does not count atomically in single threaded processes either)
+**/
+
+#include "../lexer/lexstream.hpp"           // defines lexer::LexStream used to read workloads
+#include "../parser/blockstream.hpp"        // defines parser::BlockStream used to read workloads
+#include "../parser/expressionstream.hpp"   // defines parser::ExpressionStream used to read workloads
+#include "../value/stringvalue.h"           // defines StringValue which the copied handles point to
+#include "../vm/compiler.h"                 // defines vm::Compiler used to run workloads on the vm
+#include "../vm/machine.h"                  // defines vm::Machine used to run workloads on the vm
+
+#include <chrono>                           // defines std::chrono::steady_clock used for timing
+#include <exception>                        // defines std::exception used to report failures
+#include <filesystem>                       // defines std::filesystem used to locate the temporary directory
+#include <fstream>                          // defines std::ofstream used to write workloads
+#include <memory>                           // defines std::shared_ptr used for comparison
+#include <string>                           // defines std::string
+#include <utility>                          // defines std::pair used to return both timings
+#include <vector>                           // defines std::vector used to hold parsed workloads
+
+#include <cstdio>                           // defines std::printf used to report results
+#include <cstdlib>                          // defines EXIT_SUCCESS and EXIT_FAILURE
+
+namespace {
+
+/**
+ *  @brief a recursive program, parsed once and run repeatedly
+**/
+struct Workload {
+    const char *name;
+    const char *source;
+    std::vector<Expression::expression_t> expressions;
+};
+
+/**
+ *  @brief time a single call
+ *  @return seconds taken
+**/
+template <typename function_t>
+double time(function_t function){
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ *  @brief parse every top level expression of source
+**/
+std::vector<Expression::expression_t> parse(const char *name, const char *source){
+    const std::filesystem::path filepath = std::filesystem::temp_directory_path() / (std::string("fragment_refcount_") + name + ".fr");
+    {
+        std::ofstream output(filepath);
+        output << source;
+    }
+
+    std::vector<Expression::expression_t> expressions;
+    for(Expression::expression_t expression : parser::ExpressionStream(parser::BlockStream(lexer::LexStream(filepath.c_str())))){
+        Expression::optimize(expression);
+        expressions.push_back(std::move(expression));
+    }
+
+    std::filesystem::remove(filepath);
+    return expressions;
+}
+
+/**
+ *  @brief run a workload with both engines a few times
+ *  @return best seconds taken by the tree engine and by the vm
+**/
+std::pair<double, double> run(const Workload &workload){
+    constexpr int repetitions = 5;
+
+    std::pair<double, double> best;
+    for(int i = 0; i < repetitions; ++i){
+        const double tree = time([&](){
+            ProgramState state;
+            for(const auto &expression : workload.expressions){
+                (*expression)(state);
+            }
+        });
+
+        const double vm = time([&](){
+            ProgramState state;
+            vm::Machine machine(state);
+            for(const auto &expression : workload.expressions){
+                machine.run(vm::Compiler::compile(*expression));
+            }
+        });
+
+        if(!i || tree < best.first){
+            best.first = tree;
+        }
+        if(!i || vm < best.second){
+            best.second = vm;
+        }
+    }
+    return best;
+}
+
+/**
+ *  @brief copy a handle count times, keeping every copy alive for one iteration
+ *  @return best seconds taken over a few tries
+**/
+template <typename handle_t>
+double copy(const handle_t &handle, long count){
+    constexpr int repetitions = 3;
+
+    std::vector<handle_t> copies(8, handle);
+    double best = 0;
+    for(int i = 0; i < repetitions; ++i){
+        const double seconds = time([&](){
+            for(long copied = 0; copied < count; ++copied){
+                copies[copied & 7] = handle;
+            }
+        });
+        if(!i || seconds < best){
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+} // end of anonymous namespace
+
+int main(){
+    constexpr long copies = 50000000;
+
+    std::vector<Workload> workloads = {
+        {"fib", "(define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))\n(define result (fib 24))\n", {}},
+        {"factorial", "(define factorial (lambda (n) (if (<= n 1) 1 (* n (factorial (- n 1))))))\n(define repeat (lambda (n) (if (<= n 0) 0 ((lambda (ignored) (repeat (- n 1))) (factorial 400)))))\n(define result (repeat 500))\n", {}},
+        {"tail_loop", "(define sum (lambda (n total) (if (<= n 0) total (sum (- n 1) (+ total n)))))\n(define result (sum 300000 0))\n", {}},
+        {"string_args", "(define count (lambda (n text) (if (<= n 0) text (count (- n 1) text))))\n(define result (count 300000 \"a string passed along every call\"))\n", {}}
+    };
+
+    try {
+        for(Workload &workload : workloads){
+            workload.expressions = parse(workload.name, workload.source);
+        }
+
+        const Ref<Value> handle(new StringValue("copied"));
+        const std::shared_ptr<Value> shared = std::make_shared<StringValue>("copied");
+
+        // everything single threaded first, sharing can not be undone
+        std::vector<std::pair<double, double>> plain;
+        for(const Workload &workload : workloads){
+            plain.push_back(run(workload));
+        }
+        const double plain_copy = copy(handle, copies);
+        const double shared_copy = copy(shared, copies);
+
+        RefCounted::share();
+
+        std::printf("%-12s %10s %10s %8s %10s %10s %8s\n", "workload", "tree", "tree (at)", "saved", "vm", "vm (at)", "saved");
+        for(std::size_t i = 0; i < workloads.size(); ++i){
+            const auto [tree, vm] = run(workloads[i]);
+            std::printf("%-12s %9.3fs %9.3fs %7.1f%% %9.3fs %9.3fs %7.1f%%\n", workloads[i].name, plain[i].first, tree, 100 * (1 - plain[i].first / tree), plain[i].second, vm, 100 * (1 - plain[i].second / vm));
+        }
+
+        const double atomic_copy = copy(handle, copies);
+        std::printf("\n%ld handle copies: %.3fs plain, %.3fs atomic, %.3fs std::shared_ptr\n", copies, plain_copy, atomic_copy, shared_copy);
+    } catch(const std::exception &error){
+        std::fprintf(stderr, "Benchmark failed: %s\n", error.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
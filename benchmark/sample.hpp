@@ -0,0 +1,26 @@
+/**
+ *      @file benchmark/sample.hpp
+ *      @brief defines the fragment of source the lexer and parser benchmarks repeat to generate their input
+ *      @author Anastasia Sokol
+**/
+
+#ifndef BENCHMARK_SAMPLE_HPP
+#define BENCHMARK_SAMPLE_HPP
+
+namespace benchmark {
+
+// representative fragment of source (a comment, a recursive definition, strings, numerics, and nested operators), repeated to build the generated input
+inline const char* const sample =
+    "(%% computes factorial of a value %%)\n"
+    "(define factorial (lambda (n)\n"
+    "    (if (<= n 1)\n"
+    "        (1)\n"
+    "        (* n (factorial (- n 1)))\n"
+    "    )\n"
+    "))\n"
+    "(define greeting \"Hello World\")\n"
+    "(println greeting \" \" (factorial 8) \" \" (+ 3.14159 (* 2 (- 10 4)) (/ 9 3)) true)\n";
+
+} // end of namespace benchmark
+
+#endif
@@ -0,0 +1,340 @@
+#include "astcache.h"
+
+#include "../expression/atomicexpression.h"         // defines every expression type so that they can be rebuilt
+#include "../expression/selfexpression.h"
+#include "../expression/operatorexpression.h"
+#include "../expression/defineexpression.h"
+#include "../expression/lambdaexpression.h"
+#include "../expression/conditionalexpression.h"
+#include "../expression/functionexpression.h"
+#include "../value/stringvalue.h"                   // defines StringValue::literal used to rebuild string literals
+
+#include <cstdio>                                   // defines std::fopen, std::fwrite, std::rename, and std::remove used to write the cache
+#include <cstring>                                  // defines std::memcpy and std::memcmp
+#include <ios>                                      // defines std::ios_base::failure thrown if a file can not be read
+#include <memory>                                   // defines std::unique_ptr used to manage std::FILE* ownership and std::make_unique
+
+using namespace cache;
+
+namespace {
+
+constexpr char magic[3] = {'F', 'R', 'C'};          // start of every cache file
+constexpr std::uint8_t version = 1;                 // changed whenever the layout changes, older caches are then stale
+constexpr std::uint32_t byte_order = 0x01020304;    // written in native order, a cache written with another byte order is ignored
+
+constexpr ProgramState::slot_t unresolved = std::numeric_limits<ProgramState::slot_t>::max();   // marks a string not resolved to a slot yet
+
+constexpr std::size_t header_size = sizeof(magic) + 1 + sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t);
+
+/**
+ *  @brief 64 bit FNV-1a hash of data
+**/
+std::uint64_t hash(std::string_view data) noexcept {
+    std::uint64_t result = 14695981039346656037ull;
+    for(const char c : data){
+        result = (result ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return result;
+}
+
+/**
+ *  @brief append raw bytes of a trivially copyable value
+**/
+template <typename value_t>
+void raw(std::string &output, const value_t &value){
+    output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ *  @brief decode a signed varint
+**/
+std::int64_t unzigzag(std::uint64_t value) noexcept {
+    return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/**
+ *  @brief thrown while reading a cache that is truncated or does not make sense
+**/
+struct Corrupt {};
+
+} // end of anonymous namespace
+
+std::string cache::path(const char *source){
+    return std::string(source) + ".frc";
+}
+
+std::unique_ptr<Reader> Reader::open(const char *source) noexcept(false) {
+    const lexer::SourceBuffer code(source);
+
+    std::unique_ptr<lexer::SourceBuffer> file;
+    try {
+        file = std::make_unique<lexer::SourceBuffer>(path(source).c_str());
+    } catch(std::ios_base::failure&) {
+        // no cache yet
+        return nullptr;
+    }
+
+    const std::string_view data = file->view();
+    if(data.size() < header_size || std::memcmp(data.data(), magic, sizeof(magic)) || static_cast<std::uint8_t>(data[sizeof(magic)]) != version){
+        return nullptr;
+    }
+
+    std::uint32_t order;
+    std::uint64_t source_hash, source_size, payload_hash;
+    const char *field = data.data() + sizeof(magic) + 1;
+    std::memcpy(&order, field, sizeof(order));
+    std::memcpy(&source_hash, field += sizeof(order), sizeof(source_hash));
+    std::memcpy(&source_size, field += sizeof(source_hash), sizeof(source_size));
+    std::memcpy(&payload_hash, field += sizeof(source_size), sizeof(payload_hash));
+
+    if(order != byte_order || source_size != code.view().size() || source_hash != hash(code.view()) || payload_hash != hash(data.substr(header_size))){
+        return nullptr;
+    }
+
+    // expressions are only read while the program runs, so after the hashes match only the string table is checked up front
+    try {
+        std::unique_ptr<Reader> reader(new Reader(std::move(file), header_size));
+        for(std::size_t length = reader->count(); length; --length){
+            reader->table.push_back(reader->bytes(reader->count()));
+        }
+        reader->slots.assign(reader->table.size(), unresolved);
+        reader->remaining = reader->varint();
+        return reader;
+    } catch(Corrupt&) {
+        return nullptr;
+    }
+}
+
+Reader::Reader(std::unique_ptr<lexer::SourceBuffer> mapping, std::size_t offset) : file(std::move(mapping)), cursor(file->view().data() + offset), last(file->view().data() + file->view().size()), remaining(0), line(0) {}
+
+Expression::expression_t Reader::next() noexcept(false) {
+    if(!remaining){
+        return nullptr;
+    }
+
+    try {
+        --remaining;
+        return expression();
+    } catch(Corrupt&) {
+        throw std::ios_base::failure("Corrupt expression cache, delete it to parse the source again");
+    }
+}
+
+Expression::expression_t Reader::expression(){
+    typedef Expression::expression_t exp_t;
+
+    const Tag tag = static_cast<Tag>(byte());
+    line += unzigzag(varint());
+    const Token::TokenPosition position(line, unzigzag(varint()));
+
+    switch(tag){
+        case Tag::numeric: {
+            double number;
+            std::memcpy(&number, bytes(sizeof(number)).data(), sizeof(number));
+            return exp_t(new AtomicExpression(position, Value::value_t(number)));
+        }
+        case Tag::integer:
+            return exp_t(new AtomicExpression(position, Value::value_t(double(unzigzag(varint())))));
+        case Tag::boolean:
+            return exp_t(new AtomicExpression(position, Value::value_t(byte() != 0)));
+        case Tag::string:
+            return exp_t(new AtomicExpression(position, StringValue::literal(table[index()])));
+        case Tag::reference:
+            return exp_t(new AtomicExpression(position, name()));
+        case Tag::self:
+            return exp_t(new SelfExpression(position, expression()));
+        case Tag::operation: {
+            const std::uint64_t type = varint();
+            if(type > static_cast<std::uint64_t>(OperatorExpression::OperatorType::operator_not)){
+                throw Corrupt();
+            }
+            std::list<exp_t> arguments = expressions();
+            return exp_t(new OperatorExpression(position, static_cast<OperatorExpression::OperatorType>(type), std::move(arguments)));
+        }
+        case Tag::define: {
+            const ProgramState::slot_t slot = name();
+            return exp_t(new DefineExpression(position, slot, expression()));
+        }
+        case Tag::lambda: {
+            std::vector<ProgramState::slot_t> parameters(count());
+            for(ProgramState::slot_t &parameter : parameters){
+                parameter = name();
+            }
+            return exp_t(new LambdaExpression(position, std::move(parameters), expression()));
+        }
+        case Tag::conditional: {
+            exp_t condition = expression();
+            exp_t truthy = expression();
+            return exp_t(new ConditionalExpression(position, std::move(condition), std::move(truthy), expression()));
+        }
+        case Tag::function: {
+            exp_t function = expression();
+            std::list<exp_t> arguments = expressions();
+            return exp_t(new FunctionExpression(position, std::move(function), std::move(arguments)));
+        }
+    }
+
+    throw Corrupt();
+}
+
+std::list<Expression::expression_t> Reader::expressions(){
+    std::list<Expression::expression_t> result;
+    for(std::size_t length = count(); length; --length){
+        result.push_back(expression());
+    }
+    return result;
+}
+
+std::uint8_t Reader::byte(){
+    if(cursor == last){
+        throw Corrupt();
+    }
+    return static_cast<std::uint8_t>(*cursor++);
+}
+
+std::uint64_t Reader::varint(){
+    std::uint64_t result = 0;
+    for(unsigned shift = 0; shift < 64; shift += 7){
+        const std::uint8_t next = byte();
+        result |= std::uint64_t(next & 0x7f) << shift;
+        if(!(next & 0x80)){
+            return result;
+        }
+    }
+    throw Corrupt();
+}
+
+std::size_t Reader::count(){
+    // everything counted takes at least a byte, so a corrupt count can not cause a huge allocation
+    const std::uint64_t result = varint();
+    if(result > std::uint64_t(last - cursor)){
+        throw Corrupt();
+    }
+    return result;
+}
+
+std::string_view Reader::bytes(std::size_t length){
+    if(length > std::size_t(last - cursor)){
+        throw Corrupt();
+    }
+    std::string_view result(cursor, length);
+    cursor += length;
+    return result;
+}
+
+std::size_t Reader::index(){
+    const std::uint64_t result = varint();
+    if(result >= table.size()){
+        throw Corrupt();
+    }
+    return result;
+}
+
+ProgramState::slot_t Reader::name(){
+    const std::size_t position = index();
+    if(slots[position] == unresolved){
+        slots[position] = ProgramState::resolve(table[position]);
+    }
+    return slots[position];
+}
+
+Writer::Writer() : expressions(0), line(0), valid(true) {}
+
+void Writer::add(const Expression &expression){
+    expression.serialize(*this);
+    ++expressions;
+}
+
+void Writer::save(const char *source) const {
+    if(!valid){
+        return;
+    }
+
+    std::string payload;
+    varint(payload, strings.size());
+    for(const std::string *string : strings){
+        varint(payload, string->size());
+        payload.append(*string);
+    }
+    varint(payload, expressions);
+    payload.append(body);
+
+    std::uint64_t source_hash, source_size;
+    try {
+        const lexer::SourceBuffer code(source);
+        source_hash = hash(code.view());
+        source_size = code.view().size();
+    } catch(std::ios_base::failure&) {
+        return;
+    }
+
+    std::string header(magic, sizeof(magic));
+    header.push_back(static_cast<char>(version));
+    raw(header, byte_order);
+    raw(header, source_hash);
+    raw(header, source_size);
+    raw(header, hash(payload));
+
+    // readers only ever see a complete file, anything that goes wrong just leaves the cache missing
+    const std::string target = path(source), temporary = target + ".tmp";
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(temporary.c_str(), "wb"), std::fclose);
+    if(!file){
+        return;
+    }
+
+    const bool written = std::fwrite(header.data(), 1, header.size(), file.get()) == header.size() && std::fwrite(payload.data(), 1, payload.size(), file.get()) == payload.size();
+    if(std::fclose(file.release()) || !written || std::rename(temporary.c_str(), target.c_str())){
+        std::remove(temporary.c_str());
+    }
+}
+
+void Writer::node(Tag tag, const Token::TokenPosition &position){
+    body.push_back(static_cast<char>(tag));
+    zigzag(body, position.line - line);
+    zigzag(body, position.index);
+    line = position.line;
+}
+
+void Writer::number(double value){
+    raw(body, value);
+}
+
+void Writer::integer(std::int64_t value){
+    zigzag(body, value);
+}
+
+void Writer::boolean(bool value){
+    body.push_back(value ? 1 : 0);
+}
+
+void Writer::string(const std::string &value){
+    const auto [location, inserted] = index.emplace(value, strings.size());
+    if(inserted){
+        strings.push_back(&location->first);
+    }
+    varint(body, location->second);
+}
+
+void Writer::name(ProgramState::slot_t slot){
+    string(ProgramState::name(slot));
+}
+
+void Writer::count(std::size_t value){
+    varint(body, value);
+}
+
+void Writer::invalidate() noexcept {
+    valid = false;
+}
+
+void Writer::zigzag(std::string &output, std::int64_t value){
+    varint(output, (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63));
+}
+
+void Writer::varint(std::string &output, std::uint64_t value){
+    while(value >= 0x80){
+        output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
@@ -0,0 +1,214 @@
+/**
+ *      @file cache/astcache.h
+ *      @brief defines the precompiled expression cache (.frc files) in namespace cache
+ *      @author Anastasia Sokol
+ *
+ *      a cache file stores every top level expression of a source file exactly as it was parsed (before folding), next to the source as source.frc
+ *      it is keyed by a hash of the contents of the source, so editing the source makes the cache stale and it is ignored (then written again)
+ *
+ *      layout (integers are LEB128 varints unless noted, the cache is only read on the machine that wrote it)
+ *          header:      "FRC" version(1 byte) byte_order(4 bytes, 0x01020304 as written) source_hash(8 bytes) source_size(8 bytes) payload_hash(8 bytes)
+ *          payload:     string_count {length bytes}* expression_count expression*
+ *          expression:  tag(1 byte) line(zigzag, difference from line of previous expression) index(zigzag) followed by the fields of the tag (see cache::Tag)
+ *      the file is memory mapped and expressions are built straight from the mapping one top level expression at a time, just like parsing
+ *      a cache that is stale or corrupt (checked by the hashes before anything is read) is never used, the source is parsed instead
+**/
+
+#ifndef CACHE_ASTCACHE_H
+#define CACHE_ASTCACHE_H
+
+#include "../expression/expression.hpp"     // defines Expression which is what is cached
+#include "../datatype/token.hpp"            // defines Token::TokenPosition stored with every expression
+#include "../datatype/programstate.h"       // defines ProgramState::slot_t used to store reference names
+#include "../lexer/sourcebuffer.hpp"        // defines lexer::SourceBuffer used to map cache files
+
+#include <cstddef>                          // defines std::size_t
+#include <cstdint>                          // defines std::uint8_t, std::int64_t, and std::uint64_t
+#include <iterator>                         // defines std::input_iterator_tag
+#include <limits>                           // defines std::numeric_limits used to mark names that are not resolved yet
+#include <list>                             // defines std::list used to pass expressions to constructors
+#include <memory>                           // defines std::unique_ptr used to own mapped cache files
+#include <string>                           // defines std::string
+#include <string_view>                      // defines std::string_view used to read mapped files
+#include <unordered_map>                    // defines std::unordered_map used to store each string once
+#include <vector>                           // defines std::vector used to store strings
+
+namespace cache {
+
+/**
+ *  @brief kind of a cached expression, each is followed by the fields listed (counts, indices, and operator types are varints)
+**/
+enum class Tag : std::uint8_t {
+    numeric,        // literal, 8 byte double
+    integer,        // numeric literal holding a whole number, zigzag varint
+    boolean,        // literal, 1 byte
+    string,         // literal, string index
+    reference,      // string index of name
+    self,           // expression
+    operation,      // OperatorExpression::OperatorType, count, count argument expressions
+    define,         // string index of name, expression
+    lambda,         // count, count string indices of parameter names, body expression
+    conditional,    // condition, truthy, and falsy expressions
+    function        // function expression, count, count argument expressions
+};
+
+/**
+ *  @brief get path of the cache file for a source file
+ *  @param source path of source file
+**/
+std::string path(const char*);
+
+/**
+ *  @brief stream of the expressions stored in the cache of a source file, in the same order the parser would produce them
+**/
+class Reader {
+    public:
+        /**
+         *  @brief open the cache of a source file
+         *  @param source path of source file (which must exist)
+         *  @throws std::ios_base::failure if the source file can not be read
+         *  @return stream of every top level expression of source, or nullptr if there is no cache, it is stale, or it is corrupt
+        **/
+        static std::unique_ptr<Reader> open(const char*) noexcept(false);
+
+        Reader(const Reader&) = delete;
+        Reader& operator =(const Reader&) = delete;
+
+        struct ReaderIterator {
+            private:
+                Reader *reader;                     // reader expressions are read from
+                Expression::expression_t cursor;    // stores current expression
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = Expression::expression_t;
+                using pointer           = value_type*;
+                using reference         = value_type&;
+
+                /**
+                 *  @brief create iterator, reads the first expression
+                 *  @param reader to read expressions from
+                **/
+                ReaderIterator(Reader *reader) : reader(reader) {
+                    ++*this;
+                }
+
+                /**
+                 *  @brief read next expression
+                 *  @throws std::ios_base::failure if the cache turns out to be corrupt after all
+                 *  @return reference to stream
+                **/
+                inline ReaderIterator& operator ++() noexcept(false) {
+                    cursor = reader->next();
+                    return *this;
+                }
+
+                inline const Expression::expression_t* operator ->() const noexcept {
+                    return &cursor;
+                }
+
+                inline const Expression::expression_t& operator *() const noexcept {
+                    return cursor;
+                }
+
+                inline bool operator ==(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor == (bool)other;
+                }
+
+                inline bool operator !=(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor != (bool)other;
+                }
+        };
+
+        inline ReaderIterator begin(){
+            return ReaderIterator(this);
+        }
+
+        inline const Expression::expression_t end() const noexcept {
+            return Expression::expression_t(nullptr);
+        }
+
+    private:
+        std::unique_ptr<lexer::SourceBuffer> file;  // mapped cache file
+        const char *cursor;                         // next byte to read
+        const char *last;                           // end of file
+        std::vector<std::string_view> table;        // strings referred to by index, views of the mapped file
+        std::vector<ProgramState::slot_t> slots;    // slot of every string used as a name, resolved the first time it is used
+        std::size_t remaining;                      // top level expressions not yet read
+        ssize_t line;                               // line of last expression read
+
+        Reader(std::unique_ptr<lexer::SourceBuffer>, std::size_t);
+
+        /**
+         *  @brief read next top level expression
+         *  @return expression, or nullptr once all have been read
+        **/
+        Expression::expression_t next() noexcept(false);
+
+        Expression::expression_t expression();
+        std::list<Expression::expression_t> expressions();
+
+        std::uint8_t byte();
+        std::uint64_t varint();
+        std::size_t count();
+        std::string_view bytes(std::size_t);
+        std::size_t index();
+        ProgramState::slot_t name();
+};
+
+/**
+ *  @brief collects top level expressions, then writes them as the cache of a source file
+ *  @desc used by Expression::serialize, each expression writes its tag and position with node and then its fields in the order given by Tag
+**/
+class Writer {
+    public:
+        Writer();
+
+        /**
+         *  @brief add a top level expression (must be called before the expression is folded)
+        **/
+        void add(const Expression&);
+
+        /**
+         *  @brief write the cache file for source, unless something that can not be cached was added
+         *  @desc written to a temporary file first and then renamed, so other runs never see a partial cache, failures are ignored
+         *  @param source path of source file the expressions were parsed from
+        **/
+        void save(const char*) const;
+
+        void node(Tag, const Token::TokenPosition&);
+        void number(double);
+        void integer(std::int64_t);
+        void boolean(bool);
+        void string(const std::string&);
+        void name(ProgramState::slot_t);
+        void count(std::size_t);
+
+        /**
+         *  @brief mark the cache as unusable (for example a literal that is a function), save does nothing afterwards
+        **/
+        void invalidate() noexcept;
+
+    private:
+        std::unordered_map<std::string, std::size_t> index;    // position of every string in strings
+        std::vector<const std::string*> strings;                // keys of index, in order of first use
+        std::string body;                                       // encoded expressions
+        std::size_t expressions;                                // number of top level expressions added
+        ssize_t line;                                           // line of last node written, lines are stored as differences
+        bool valid;                                             // false once invalidate was called
+
+        /**
+         *  @brief append an unsigned varint to output
+        **/
+        static void varint(std::string&, std::uint64_t);
+
+        /**
+         *  @brief append a signed varint to output, small magnitudes of either sign take a single byte
+        **/
+        static void zigzag(std::string&, std::int64_t);
+};
+
+} // end of namespace cache
+
+#endif
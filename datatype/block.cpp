@@ -1,21 +1,23 @@
 #include "block.h"
 
-Block::Block(const Token::TokenPosition position) noexcept : position(position) {}
-Block::Block() noexcept {}
+Block::Block(const Token::TokenPosition position) noexcept(false) : nodes{Node{Token("Block", position, Token::TokenType::null), 1, 0, true}} {}
+Block::Block() noexcept(false) : Block(Token::TokenPosition()) {}
 
-Block& Block::append(std::variant<Token, Block> value) {
-    view.push_back(value);
+Block& Block::append(const Token &token, std::uint32_t parent) noexcept(false) {
+    nodes.push_back(Node{token, (std::uint32_t)nodes.size() + 1, 0, false});
+    ++nodes[parent].size;
+    nodes[0].end = nodes.size();
     return *this;
 }
 
-Block::list_iterator_begin_type Block::begin() noexcept {
-    return view.begin();
+std::uint32_t Block::open(const Token::TokenPosition &position, std::uint32_t parent) noexcept(false) {
+    const std::uint32_t index = nodes.size();
+    nodes.push_back(Node{Token("Block", position, Token::TokenType::null), index + 1, 0, true});
+    ++nodes[parent].size;
+    nodes[0].end = nodes.size();
+    return index;
 }
 
-Block::list_iterator_end_type Block::end() noexcept {
-    return view.end();
+void Block::close(std::uint32_t block) noexcept {
+    nodes[block].end = nodes.size();
 }
-
-size_t Block::size() const noexcept {
-    return view.size();
-}
\ No newline at end of file
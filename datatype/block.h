@@ -2,6 +2,9 @@
  *      @file datatype/block.h
  *      @brief defines the Block datatype for generic organization of Tokens
  *      @author Anastasia Sokol
+ *
+ *      a Block owns a flat arena of nodes for an entire top level block, nested blocks do not allocate anything of their own
+ *      nodes are stored in pre-order, so the children of a block are found by starting right after it and skipping over each child's subtree
 **/
 
 #ifndef DATATYPE_BLOCK_H
@@ -9,47 +12,189 @@
 
 #include "token.hpp"
 
-#include <type_traits>  // defines std::declval used to get the std::list iterator type
-#include <list>         // defines std::list used to store tokens and blocks
-#include <variant>      // defines std::varient used to store a mix of tokens and blocks in the same list
+#include <cstdint>      // defines std::uint32_t used to index nodes
+#include <iterator>     // defines std::forward_iterator_tag used to tag Block::Element::Iterator
+#include <vector>       // defines std::vector used to store the node arena
 
 /**
  *  @brief defines a block of tokens which are logically grouped together and which may contain other blocks
 **/
 struct Block {
-    // these horrors of types are used so that Block can become iterable by using std::list's iterator
-    typedef decltype(std::declval<std::list<std::variant<Token, Block>>>().begin()) list_iterator_begin_type;
-    typedef decltype(std::declval<std::list<std::variant<Token, Block>>>().end()) list_iterator_end_type;
+    /**
+     *  @brief a single token or nested block stored in the arena
+    **/
+    struct Node {
+        Token token;            // token if this node is a token, otherwise holds only the position of the block
+        std::uint32_t end;      // index one past the last node in this subtree (index + 1 for tokens and empty blocks)
+        std::uint32_t size;     // number of direct children (always 0 for tokens)
+        bool block;             // true if this node is a block
+    };
+
+    /**
+     *  @brief lightweight handle to a node of a block, either a token or a nested block
+     *
+     *  only valid for as long as the Block that owns the node
+    **/
+    class Element {
+        private:
+            const Block *owner;     // arena the element lives in
+            std::uint32_t index;    // position of element in arena
+
+            inline const Node& node() const noexcept {
+                return owner->nodes[index];
+            }
+
+        public:
+            /**
+             *  @brief iterate over the direct children of a block element
+            **/
+            struct Iterator {
+                using iterator_category = std::forward_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = Element;
+                using pointer           = const Element*;
+                using reference         = Element;
+
+                const Block *owner;     // arena being iterated over
+                std::uint32_t index;    // current child
+
+                inline Element operator *() const noexcept {
+                    return Element(owner, index);
+                }
+
+                inline Iterator& operator ++() noexcept {
+                    index = owner->nodes[index].end;
+                    return *this;
+                }
+
+                inline bool operator ==(const Iterator &other) const noexcept {
+                    return index == other.index;
+                }
+
+                inline bool operator !=(const Iterator &other) const noexcept {
+                    return index != other.index;
+                }
+            };
+
+            inline Element(const Block *owner, std::uint32_t index) noexcept : owner(owner), index(index) {}
+
+            /**
+             *  @brief check if element is a token
+            **/
+            inline bool is_token() const noexcept {
+                return !node().block;
+            }
+
+            /**
+             *  @brief check if element is a nested block
+            **/
+            inline bool is_block() const noexcept {
+                return node().block;
+            }
+
+            /**
+             *  @brief get token, only meaningful if is_token()
+            **/
+            inline const Token& token() const noexcept {
+                return node().token;
+            }
+
+            /**
+             *  @brief position of token, or of the first token in block
+            **/
+            inline const Token::TokenPosition& position() const noexcept {
+                return node().token.position;
+            }
+
+            /**
+             *  @brief number of direct children (0 for tokens)
+            **/
+            inline std::size_t size() const noexcept {
+                return node().size;
+            }
 
-    std::list<std::variant<Token, Block>> view; // store ordered collection or tokens and blocks that make up the block
-    Token::TokenPosition position;              // store position of first token in block (likely a bracket which should not be stored in view)
+            /**
+             *  @brief first child of block, block must not be empty
+            **/
+            inline Element front() const noexcept {
+                return Element(owner, index + 1);
+            }
 
-    Block(const Token::TokenPosition) noexcept;
-    Block() noexcept;
+            inline Iterator begin() const noexcept {
+                return Iterator{owner, index + 1};
+            }
+
+            inline Iterator end() const noexcept {
+                return Iterator{owner, node().end};
+            }
+    };
+
+    std::vector<Node> nodes;    // arena of every token and block that make up the block, nodes[0] is the block itself
+
+    Block(const Token::TokenPosition) noexcept(false);
+    Block() noexcept(false);
 
     /**
-     *  @brief append either a token or another block to this blocks internal view
+     *  @brief append a token to a block in the arena
+     *  @param token to append
+     *  @param parent index of the block to append to (defaults to the top level block)
      *  @throws std::bad_alloc in the case of a failed allocation
+     *  @return reference to this
     **/
-    Block& append(std::variant<Token, Block>) noexcept(false);
-    
+    Block& append(const Token&, std::uint32_t parent = 0) noexcept(false);
+
+    /**
+     *  @brief start a nested block, following appends to the returned index go into it until close is called
+     *  @param position of the first token in the nested block
+     *  @param parent index of the block to append to
+     *  @throws std::bad_alloc in the case of a failed allocation
+     *  @return index of the new block
+    **/
+    std::uint32_t open(const Token::TokenPosition&, std::uint32_t parent) noexcept(false);
+
+    /**
+     *  @brief finish a nested block started with open
+     *  @param block index returned by open
+    **/
+    void close(std::uint32_t) noexcept;
+
+    /**
+     *  @brief get the top level block as an element
+    **/
+    inline Element root() const noexcept {
+        return Element(this, 0);
+    }
+
+    /**
+     *  @brief equivelent to root().begin()
+     *  @return iterater to first child of block
+    **/
+    inline Element::Iterator begin() const noexcept {
+        return root().begin();
+    }
+
     /**
-     *  @brief equivelent to Block.view.begin()
-     *  @return iterater to start of block view
+     *  @brief equivelent to root().end()
+     *  @return end of block iterater
     **/
-    list_iterator_begin_type begin() noexcept;
+    inline Element::Iterator end() const noexcept {
+        return root().end();
+    }
 
     /**
-     *  @brief equivelent to Block.view.end()
-     *  @return end of block view iterater
+     *  @brief get number of direct children of top level block
+     *  @return root().size()
     **/
-    list_iterator_end_type end() noexcept;
+    inline std::size_t size() const noexcept {
+        return root().size();
+    }
 
     /**
-     *  @brief get size of view list
-     *  @return view.size()
+     *  @brief position of first token in block (likely a bracket which is not stored)
     **/
-    size_t size() const noexcept;
+    inline const Token::TokenPosition& position() const noexcept {
+        return root().position();
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,78 @@
+/**
+ *      @file datatype/boundedqueue.hpp
+ *      @brief defines BoundedQueue, a fixed size lock free queue between exactly one producer thread and one consumer thread
+ *      @author Anastasia Sokol
+ *
+ *      used to hand expressions from the background parser to the thread running them (see parser::PipelinedExpressionStream)
+ *      extended .hpp since the whole class is a template
+**/
+
+#ifndef DATATYPE_BOUNDEDQUEUE_H
+#define DATATYPE_BOUNDEDQUEUE_H
+
+#include <array>        // defines std::array used to store elements
+#include <atomic>       // defines std::atomic used for the read and write positions
+#include <cstddef>      // defines std::size_t
+#include <utility>      // defines std::move
+
+/**
+ *  @brief single producer, single consumer ring buffer
+ *  @desc positions only ever increase, the producer owns tail and the consumer owns head, so neither side ever waits on a lock
+ *  @param element_t type of element, must be default constructible and movable
+ *  @param capacity maximum number of elements waiting in the queue
+**/
+template <typename element_t, std::size_t capacity>
+class BoundedQueue {
+    private:
+        std::array<element_t, capacity> slots;      // element at position p is stored in slots[p % capacity]
+        alignas(64) std::atomic<std::size_t> head;  // position of next element to pop, only changed by the consumer
+        alignas(64) std::atomic<std::size_t> tail;  // position of next element to push, only changed by the producer
+
+    public:
+        inline BoundedQueue() : slots(), head(0), tail(0) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator =(const BoundedQueue&) = delete;
+
+        /**
+         *  @brief number of elements waiting, only exact if neither side is changing the queue
+        **/
+        inline std::size_t size() const noexcept {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        /**
+         *  @brief add element to the back, only called by the producer
+         *  @param element to add, moved from only if there was space
+         *  @return false if the queue is full
+        **/
+        inline bool try_push(element_t &element){
+            const std::size_t position = tail.load(std::memory_order_relaxed);
+            if(position - head.load(std::memory_order_acquire) == capacity){
+                return false;
+            }
+
+            slots[position % capacity] = std::move(element);
+            tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         *  @brief remove element from the front, only called by the consumer
+         *  @param element set to the element removed
+         *  @return false if the queue is empty
+        **/
+        inline bool try_pop(element_t &element){
+            const std::size_t position = head.load(std::memory_order_relaxed);
+            if(position == tail.load(std::memory_order_acquire)){
+                return false;
+            }
+
+            element = std::move(slots[position % capacity]);
+            slots[position % capacity] = element_t();
+            head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+};
+
+#endif
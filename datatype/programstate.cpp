@@ -2,30 +2,104 @@
 
 #include "invalidstate.hpp"
 
-ProgramState::ProgramState(){
-    this->push();
+#include <deque>            // defines std::deque used so that names never move once resolved
+#include <mutex>            // defines std::mutex used so that names can be resolved while expressions run on another thread
+#include <unordered_map>    // defines std::unordered_map used to resolve names into slots
+
+/**
+ *  @brief names resolved so far, shared by every ProgramState so that expressions can be resolved once and run anywhere
+ *  @desc keys are views of names, which never move, so looking up a name that was already resolved never copies it
+**/
+struct SymbolTable {
+    std::mutex lock;                                                    // guards slots and names (see parser::PipelinedExpressionStream)
+    std::unordered_map<std::string_view, ProgramState::slot_t> slots;   // name to slot, the hash of every name is stored with it
+    std::deque<std::string> names;                                      // slot to name
+};
+
+static SymbolTable& symbols(){
+    static SymbolTable table;
+    return table;
+}
+
+thread_local std::uint64_t ProgramState::generation = 0;
+
+thread_local ProgramState *ProgramState::current = nullptr;
+
+ProgramState::ProgramState() : base(nullptr) {}
+
+ProgramState::ProgramState(const ProgramState *base) : base(base) {}
+
+ProgramState::slot_t ProgramState::resolve(std::string_view name){
+    SymbolTable &table = symbols();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    const auto location = table.slots.find(name);
+    if(location != table.slots.end()){
+        return location->second;
+    }
+
+    const slot_t slot = table.names.size();
+    table.slots.emplace(table.names.emplace_back(name), slot);
+    return slot;
+}
+
+const std::string& ProgramState::name(slot_t slot){
+    SymbolTable &table = symbols();
+    std::lock_guard<std::mutex> guard(table.lock);
+    return table.names[slot];
 }
 
 void ProgramState::push(){
-    scope.push_back(std::unordered_map<std::string, Value::value_t>());
+    scope.push_back(shadows.size());
 }
 
 void ProgramState::pop(){
+    const std::size_t base = scope.back();
     scope.pop_back();
+
+    // restore in reverse so that a slot set twice in the scope ends up with its oldest binding
+    while(shadows.size() > base){
+        Shadow &shadow = shadows.back();
+        bindings[shadow.slot] = std::move(shadow.previous);
+        shadows.pop_back();
+    }
+}
+
+Value::value_t ProgramState::set(slot_t slot, Value::value_t value){
+    if(slot >= bindings.size()){
+        bindings.resize(slot + 1, Binding{Value::value_t(), unbound, 0});
+    }
+
+    Binding &binding = bindings[slot];
+    const std::size_t depth = scope.size();
+
+    if(binding.depth != depth){
+        // first set in this scope, remember what to restore (nothing is ever restored over global scope)
+        if(depth){
+            shadows.push_back(Shadow{slot, binding});
+        }
+        binding.depth = depth;
+    }
+
+    binding.version = ++generation;
+    return binding.value = std::move(value);
 }
 
 Value::value_t ProgramState::set(const std::string &name, Value::value_t value){
-    scope.back()[name] = value;
-    return value;
+    return set(resolve(name), std::move(value));
 }
 
-Value::value_t ProgramState::get(const std::string &name) const {
-    for (auto it = scope.rbegin(); it != scope.rend(); ++it){
-        auto location = it->find(name);
-        if(location != it->end()){
-            return location->second;
+const Value::value_t& ProgramState::get(slot_t slot) const {
+    if(slot >= bindings.size() || bindings[slot].depth == unbound){
+        if(base){
+            return base->get(slot);
         }
+        throw InvalidState("Unable to find a reference with name [" + name(slot) + "] in any scope");
     }
 
-    throw InvalidState("Unable to find a reference with name [" + name + "] in any scope");
-}
\ No newline at end of file
+    return bindings[slot].value;
+}
+
+const Value::value_t& ProgramState::get(const std::string &name) const {
+    return get(resolve(name));
+}
@@ -1,7 +1,17 @@
 /**
  *      @file datatype/programstate.h
  *      @brief defines ProgramState structure which can be passed to expressions
- *      @author Anastasia Sokol 
+ *      @author Anastasia Sokol
+ *
+ *      references are dynamically scoped, a lambda body sees whatever its caller can see
+ *      this is implemented with shallow binding; every reference name is resolved once (when the expression is built) to a slot,
+ *      each slot holds the current value of that name, and scopes only remember the values they shadowed so they can be restored on pop
+ *      this makes every lookup an indexed load no matter how deep the scope chain is
+ *
+ *      every set stamps the binding with a new version, so a cached lookup stays valid for as long as the version of its slot does not change (see FunctionExpression)
+ *
+ *      a state may be layered over another one (see frstd::pmap), references it has not set itself are read from the other state, which it never changes
+ *      this lets every worker thread run with its own bindings and scopes while sharing what the caller could see
 **/
 
 #ifndef DATATYPE_PROGRAMSTATE_H
@@ -9,32 +19,105 @@
 
 #include "../value/value.hpp"   // defines Value::value_t which is the type references are mapped to
 
-#include <unordered_map>        // defines std::unordered_map used to make reference lookups
-#include <vector>               // defines std::vector used to manage scope
+#include <cstdint>              // defines std::uint32_t used for slots and std::uint64_t used for versions
+#include <string>               // defines std::string used for reference names
+#include <string_view>          // defines std::string_view used to resolve names straight from source text
+#include <vector>               // defines std::vector used to manage bindings and scope
 
 /**
  *  @brief used to manage state to otherwise stateless expressions
 **/
 struct ProgramState {
+    public:
+        typedef std::uint32_t slot_t;   // index of a reference name, shared by every ProgramState
+
     private:
-        std::vector<std::unordered_map<std::string, Value::value_t>> scope; // stores references in a way that can be managed by scope
+        /**
+         *  @brief current value of a single reference
+        **/
+        struct Binding {
+            Value::value_t value;   // value of reference
+            std::size_t depth;      // scope depth the value was set in, or unbound if the reference has no value
+            std::uint64_t version;  // stamp of the set that created this binding, or 0 if unbound
+        };
+
+        /**
+         *  @brief binding replaced by a set in a nested scope
+        **/
+        struct Shadow {
+            slot_t slot;        // slot that was set
+            Binding previous;   // binding to restore when the scope is popped
+        };
+
+        static constexpr std::size_t unbound = -1;  // depth of bindings that do not hold a value
+
+        static thread_local std::uint64_t generation;   // last version handed out on this thread, shared by every ProgramState on it so versions are never reused
+
+        std::vector<Binding> bindings;  // current binding of every slot, may be shorter than the number of resolved names
+        std::vector<Shadow> shadows;    // flat stack of every binding shadowed by an active scope
+        std::vector<std::size_t> scope; // size of shadows when each (non global) scope was pushed
+        const ProgramState *base;       // state references are read from if this one has not set them, or nullptr
 
     public:
         /**
-         *  @brief initializes state to be global scope 
+         *  @brief state closures called on this thread run in, instead of the state they were created in (unless nullptr)
+         *  @desc set by main to its only state, and by frstd::pmap and frstd::preduce to the state of each worker
+        **/
+        static thread_local ProgramState *current;
+
+        /**
+         *  @brief initializes state to be global scope
         **/
         ProgramState();
 
         /**
-         *  @brief create a new scope 
+         *  @brief initializes state to be global scope layered over another state
+         *  @param base state to read references this state has not set from, must outlive this state and not change while it is used
+        **/
+        explicit ProgramState(const ProgramState*);
+
+        /**
+         *  @brief check if this state is layered over another state
+         *  @desc versions are not tracked for references read from the base state, and layered states may be used by threads other than the main one
+        **/
+        inline bool layered() const noexcept {
+            return base;
+        }
+
+        /**
+         *  @brief get the slot used for a reference name, assigning a new one if the name has not been seen before
+         *  @desc thread safe, so that expressions can be built on one thread while others run (see parser::PipelinedExpressionStream)
+         *        names are interned, the name is only copied the first time it is resolved
+         *  @param name of reference
+         *  @return slot of reference
+        **/
+        static slot_t resolve(std::string_view);
+
+        /**
+         *  @brief get the reference name a slot was resolved from
+         *  @param slot returned by resolve
+         *  @return name of reference
+        **/
+        static const std::string& name(slot_t);
+
+        /**
+         *  @brief create a new scope
         **/
         void push();
 
         /**
-         *  @brief remove top scope 
+         *  @brief remove top scope, restoring every binding it shadowed
         **/
         void pop();
 
+        /**
+         *  @brief set reference to value in *top scope*
+         *  @param slot of reference
+         *  @param value value_t representing the value stored by reference
+         *  @return value_t just set
+        **/
+        Value::value_t set(slot_t, Value::value_t);
+
         /**
          *  @brief set reference to value in *top scope*
          *  @param name string representing name of reference
@@ -42,14 +125,32 @@ struct ProgramState {
          *  @return value_t just set
         **/
         Value::value_t set(const std::string&, Value::value_t);
-        
+
+        /**
+         *  @brief get version of the current binding of a reference
+         *  @desc changes whenever the reference is set (or a scope that set it is popped), never reused
+         *  @param slot of reference
+         *  @return version of binding, or 0 if the reference has no value (or is only set in the base state)
+        **/
+        inline std::uint64_t version(slot_t slot) const noexcept {
+            return slot < bindings.size() ? bindings[slot].version : 0;
+        }
+
+        /**
+         *  @brief get value stored by reference in the innermost scope that set it
+         *  @param slot of reference
+         *  @return value_t refered to by slot
+         *  @throw InvalidState if reference not found
+        **/
+        const Value::value_t& get(slot_t) const noexcept(false);
+
         /**
-         *  @brief get value stored by reference starting at current scope going down
+         *  @brief get value stored by reference in the innermost scope that set it
          *  @param name string representing name of reference
          *  @return value_t refered to by given string
          *  @throw InvalidState if reference not found
         **/
-        Value::value_t get(const std::string&) const noexcept(false);
+        const Value::value_t& get(const std::string&) const noexcept(false);
 };
 
-#endif
\ No newline at end of file
+#endif
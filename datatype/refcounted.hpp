@@ -0,0 +1,156 @@
+/**
+ *      @file datatype/refcounted.hpp
+ *      @brief defines RefCounted, a base class for objects that count their own references, and Ref, the handle that owns them
+ *      @author Anastasia Sokol
+ *
+ *      used for values (see Value::value_t) and expressions (see Expression::expression_t), which are copied on every call
+ *      the count lives in the object itself, so there is no separate control block and a handle is a single pointer
+ *
+ *      counts are only updated with atomic instructions once a second thread may use them (see RefCounted::share), which is never for most programs
+ *      build with -DFRAGMENT_ATOMIC_REFCOUNT to always use atomic instructions, for example when embedding the interpeter in a program with threads of its own
+ *      extended .hpp since every function is inline
+**/
+
+#ifndef DATATYPE_REFCOUNTED_H
+#define DATATYPE_REFCOUNTED_H
+
+#include <atomic>       // defines std::atomic used to count references
+#include <cstddef>      // defines std::nullptr_t
+#include <cstdint>      // defines std::uint32_t
+#include <type_traits>  // defines std::enable_if_t and std::is_convertible_v used to convert handles of derived types
+
+/**
+ *  @brief base of objects owned by Ref, deleted when the last Ref to them is destroyed
+**/
+class RefCounted {
+    private:
+        mutable std::uint32_t references;               // number of Ref that point to this, only updated with atomic builtins once shared is set
+        static inline std::atomic<bool> shared{false};  // set once counts may be updated by more than one thread
+
+#ifdef FRAGMENT_ATOMIC_REFCOUNT
+        static constexpr bool always_atomic = true;     // set at build time, see top of file
+#else
+        static constexpr bool always_atomic = false;
+#endif
+
+        /**
+         *  @brief true if counts have to be updated with atomic instructions
+        **/
+        static inline bool atomic() noexcept {
+            return always_atomic || shared.load(std::memory_order_relaxed);
+        }
+
+    public:
+        /**
+         *  @brief use atomic instructions for every count from now on
+         *  @desc must be called before starting a thread that may copy or destroy a Ref (see frstd::ThreadPool and parser::PipelinedExpressionStream)
+         *        starting the thread then orders every count updated without atomic instructions before anything the thread does
+        **/
+        static inline void share() noexcept {
+            if(!shared.load(std::memory_order_relaxed)){
+                shared.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        inline void retain() const noexcept {
+            if(atomic()){
+                __atomic_fetch_add(&references, 1, __ATOMIC_RELAXED);
+            } else {
+                ++references;
+            }
+        }
+
+        inline void release() const noexcept {
+            if(atomic()){
+                if(__atomic_fetch_sub(&references, 1, __ATOMIC_ACQ_REL) == 1){
+                    delete this;
+                }
+            } else if(!--references){
+                delete this;
+            }
+        }
+
+        virtual ~RefCounted() = default;
+
+    protected:
+        // a copy is a new object, nothing refers to it yet
+        inline RefCounted() noexcept : references(0) {}
+        inline RefCounted(const RefCounted&) noexcept : references(0) {}
+        inline RefCounted& operator =(const RefCounted&) noexcept { return *this; }
+};
+
+/**
+ *  @brief shared owner of a RefCounted object, or null
+**/
+template <typename type_t>
+class Ref {
+    private:
+        type_t *pointer;
+
+        template <typename other_t>
+        friend class Ref;
+
+    public:
+        inline Ref() noexcept : pointer(nullptr) {}
+        inline Ref(std::nullptr_t) noexcept : pointer(nullptr) {}
+
+        /**
+         *  @brief share ownership of object, which may already be owned by other Ref (for example this inside a member function)
+        **/
+        inline explicit Ref(type_t *object) noexcept : pointer(object) {
+            if(pointer){
+                pointer->retain();
+            }
+        }
+
+        inline Ref(const Ref &other) noexcept : Ref(other.pointer) {}
+        inline Ref(Ref &&other) noexcept : pointer(other.pointer) { other.pointer = nullptr; }
+
+        template <typename other_t, typename = std::enable_if_t<std::is_convertible_v<other_t*, type_t*>>>
+        inline Ref(const Ref<other_t> &other) noexcept : Ref(other.pointer) {}
+
+        template <typename other_t, typename = std::enable_if_t<std::is_convertible_v<other_t*, type_t*>>>
+        inline Ref(Ref<other_t> &&other) noexcept : pointer(other.pointer) { other.pointer = nullptr; }
+
+        inline ~Ref(){
+            if(pointer){
+                pointer->release();
+            }
+        }
+
+        inline Ref& operator =(const Ref &other) noexcept {
+            // the old object is released last, its destructor may lead back here
+            type_t *previous = pointer;
+            pointer = other.pointer;
+            if(pointer){
+                pointer->retain();
+            }
+            if(previous){
+                previous->release();
+            }
+            return *this;
+        }
+
+        inline Ref& operator =(Ref &&other) noexcept {
+            if(this != &other){
+                type_t *previous = pointer;
+                pointer = other.pointer;
+                other.pointer = nullptr;
+                if(previous){
+                    previous->release();
+                }
+            }
+            return *this;
+        }
+
+        inline type_t* get() const noexcept { return pointer; }
+        inline type_t& operator *() const noexcept { return *pointer; }
+        inline type_t* operator ->() const noexcept { return pointer; }
+
+        inline explicit operator bool() const noexcept { return pointer; }
+
+        inline bool operator ==(const Ref &other) const noexcept { return pointer == other.pointer; }
+        inline bool operator !=(const Ref &other) const noexcept { return pointer != other.pointer; }
+};
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ *      @file datatype/smallvector.hpp
+ *      @brief defines SmallVector, a growable array that keeps its first few elements inline
+ *      @author Anastasia Sokol
+ *
+ *      used to collect the arguments of a call, so that calls with few arguments do not allocate
+ *      extended .hpp since the whole class is a template
+**/
+
+#ifndef DATATYPE_SMALLVECTOR_H
+#define DATATYPE_SMALLVECTOR_H
+
+#include <array>        // defines std::array used to store elements inline
+#include <cstddef>      // defines std::size_t
+#include <utility>      // defines std::move
+#include <vector>       // defines std::vector used to store elements once there are too many to keep inline
+
+/**
+ *  @brief contiguous sequence of elements, the first capacity elements are stored inline
+ *  @desc once more than capacity elements are added every element is moved to the heap (so data() is always contiguous)
+ *  @param element_t type of element, must be default constructible and cheap to default construct
+ *  @param capacity number of elements stored without allocating
+**/
+template <typename element_t, std::size_t capacity>
+class SmallVector {
+    private:
+        std::array<element_t, capacity> local;  // elements while count <= capacity
+        std::vector<element_t> spilled;         // elements while count > capacity
+        std::size_t count;                      // number of elements
+
+    public:
+        inline SmallVector() : local(), spilled(), count(0) {}
+
+        inline SmallVector(SmallVector &&other) : local(std::move(other.local)), spilled(std::move(other.spilled)), count(other.count) {
+            other.count = 0;
+        }
+
+        inline SmallVector& operator =(SmallVector &&other){
+            local = std::move(other.local);
+            spilled = std::move(other.spilled);
+            count = other.count;
+            other.count = 0;
+            return *this;
+        }
+
+        SmallVector(const SmallVector&) = delete;
+        SmallVector& operator =(const SmallVector&) = delete;
+
+        /**
+         *  @brief add element to the end
+         *  @param element to add
+        **/
+        inline void push_back(element_t element){
+            if(count < capacity){
+                local[count++] = std::move(element);
+                return;
+            }
+
+            if(count == capacity){
+                spilled.reserve(capacity * 2);
+                for(element_t &moved : local){
+                    spilled.push_back(std::move(moved));
+                    moved = element_t();
+                }
+            }
+
+            spilled.push_back(std::move(element));
+            ++count;
+        }
+
+        /**
+         *  @brief remove every element (inline elements are reset to a default constructed element)
+        **/
+        inline void clear(){
+            if(count > capacity){
+                spilled.clear();
+            } else {
+                for(std::size_t i = 0; i < count; ++i){
+                    local[i] = element_t();
+                }
+            }
+            count = 0;
+        }
+
+        inline element_t* data() noexcept {
+            return count > capacity ? spilled.data() : local.data();
+        }
+
+        inline const element_t* data() const noexcept {
+            return count > capacity ? spilled.data() : local.data();
+        }
+
+        inline std::size_t size() const noexcept {
+            return count;
+        }
+
+        inline bool empty() const noexcept {
+            return !count;
+        }
+
+        inline element_t& operator [](std::size_t index) noexcept {
+            return data()[index];
+        }
+
+        inline const element_t& operator [](std::size_t index) const noexcept {
+            return data()[index];
+        }
+
+        inline element_t* begin() noexcept { return data(); }
+        inline element_t* end() noexcept { return data() + count; }
+        inline const element_t* begin() const noexcept { return data(); }
+        inline const element_t* end() const noexcept { return data() + count; }
+};
+
+#endif
@@ -11,11 +11,13 @@
 
 #include <stdexcept>    // defines std::runtime_error
 #include <string>       // defines std::string
+#include <string_view>  // defines std::string_view used to refer to token text without copying it
 
 /**
  *  @brief represents symbolic concept of language token
  * 
  *  designed to be a normalized form of language morphemes returned by lexstream 
+ *  the token does not own its text, value points into storage owned by the LexStream::LexStreamIterator that produced it (or a string literal)
 **/
 struct Token {
     /**
@@ -56,7 +58,7 @@ struct Token {
         inline TokenPosition(const ssize_t line, const ssize_t index) : line(line), index(index) {}
     };
 
-    std::string value;      // used to store the token string value that the token represents
+    std::string_view value; // used to store the token string value that the token represents
     TokenPosition position; // used to store starting position of token string in input file
     TokenType type;         // tells which language morpheme the token represents
 
@@ -67,7 +69,7 @@ struct Token {
      *  @param position token string position in input file, forwarded to internal constructor
      *  @param type token string type, forwarded to internal constructor
     **/
-    inline Token(const std::string& value, const TokenPosition& position, const TokenType type) noexcept : value(value), position(position), type(type) {}
+    inline Token(const std::string_view value, const TokenPosition& position, const TokenType type) noexcept : value(value), position(position), type(type) {}
     
     /**
      *  @brief creates default (invalid) token
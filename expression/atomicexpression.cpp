@@ -1,11 +1,71 @@
 #include "atomicexpression.h"
 
+#include "../vm/compiler.h"     // defines vm::Compiler
+#include "../cache/astcache.h"  // defines cache::Writer
+
+#include <algorithm>            // defines std::find used to look for bound references
+#include <cmath>                // defines std::fabs, std::trunc, and std::signbit used to find whole numbers
+#include <cstdint>              // defines std::int64_t
+
 AtomicExpression::AtomicExpression(const Token::TokenPosition &position, Value::value_t value) : Expression(position), reference(false), value(value) {}
-AtomicExpression::AtomicExpression(const Token::TokenPosition &position, std::string value) : Expression(position), reference(true), value(value) {}
+AtomicExpression::AtomicExpression(const Token::TokenPosition &position, ProgramState::slot_t slot) : Expression(position), reference(true), value(slot) {}
 
 Value::value_t AtomicExpression::operator ()(ProgramState& state) const {
     if(reference){
-        return state.get(std::get<std::string>(value));
+        return state.get(std::get<ProgramState::slot_t>(value));
     }
     return std::get<Value::value_t>(value);
+}
+
+const Value::value_t* AtomicExpression::literal() const noexcept {
+    return reference ? nullptr : &std::get<Value::value_t>(value);
+}
+
+const ProgramState::slot_t* AtomicExpression::slot() const noexcept {
+    return reference ? &std::get<ProgramState::slot_t>(value) : nullptr;
+}
+
+bool AtomicExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    return !reference || std::find(bound.begin(), bound.end(), std::get<ProgramState::slot_t>(value)) != bound.end();
+}
+
+void AtomicExpression::compile(vm::Compiler &compiler) const {
+    if(reference){
+        compiler.emit(vm::OpCode::load_reference, std::get<ProgramState::slot_t>(value), position);
+    } else {
+        compiler.emit(vm::OpCode::push_constant, compiler.constant(std::get<Value::value_t>(value)), position);
+    }
+}
+
+void AtomicExpression::serialize(cache::Writer &writer) const {
+    if(reference){
+        writer.node(cache::Tag::reference, position);
+        writer.name(std::get<ProgramState::slot_t>(value));
+        return;
+    }
+
+    const Value::value_t &literal = std::get<Value::value_t>(value);
+    switch(literal.type()){
+        case ValueType::numeric:
+            // whole numbers (most literals) are stored as varints, anything that would not survive the round trip (including -0) as a double
+            if(const double number = literal.numeric(); std::fabs(number) <= 0x1p53 && number == std::trunc(number) && !(number == 0 && std::signbit(number))){
+                writer.node(cache::Tag::integer, position);
+                writer.integer(static_cast<std::int64_t>(number));
+            } else {
+                writer.node(cache::Tag::numeric, position);
+                writer.number(number);
+            }
+            break;
+        case ValueType::boolean:
+            writer.node(cache::Tag::boolean, position);
+            writer.boolean(literal.boolean());
+            break;
+        case ValueType::string:
+            writer.node(cache::Tag::string, position);
+            writer.string(literal.string());
+            break;
+        default:
+            // function values never come from source text
+            writer.invalidate();
+    }
 }
\ No newline at end of file
@@ -9,7 +9,7 @@
 
 #include "expression.hpp"   // defines Expression
 
-#include <variant>          // defines std::variant used to store an ambigious Value::value_t or std::string reference name
+#include <variant>          // defines std::variant used to store an ambigious Value::value_t or reference slot
 
 struct AtomicExpression : public Expression {
     public:
@@ -23,9 +23,9 @@ struct AtomicExpression : public Expression {
         /**
          *  @brief create abstract atomic expression with reference
          *  @param position of first token
-         *  @param reference name to lookup value of when called 
+         *  @param reference slot (see ProgramState::resolve) to lookup value of when called 
         **/
-        AtomicExpression(const Token::TokenPosition&, std::string);
+        AtomicExpression(const Token::TokenPosition&, ProgramState::slot_t);
 
         /**
          *  @brief get the atomic value stored in expression
@@ -33,9 +33,37 @@ struct AtomicExpression : public Expression {
         **/
         Value::value_t operator ()(ProgramState&) const;
 
+        /**
+         *  @brief emit instruction to push value or load reference
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief get value if this is not a reference
+         *  @return pointer to value, or nullptr for references
+        **/
+        const Value::value_t* literal() const noexcept;
+
+        /**
+         *  @brief get slot if this is a reference
+         *  @return pointer to slot, or nullptr for values
+        **/
+        const ProgramState::slot_t* slot() const noexcept;
+
+        /**
+         *  @brief values are pure, references are pure if they are bound
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
+
     private:
         bool reference;                                     // stores if this stores a value or a reference to a value
-        std::variant<Value::value_t, std::string> value;    // either a value or a reference to a value
+        std::variant<Value::value_t, ProgramState::slot_t> value;   // either a value or the slot of a reference to a value
 };
 
 #endif
\ No newline at end of file
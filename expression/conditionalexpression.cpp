@@ -1,11 +1,62 @@
 #include "conditionalexpression.h"
 
+#include "../vm/compiler.h"     // defines vm::Compiler
+#include "../cache/astcache.h"  // defines cache::Writer
+
 ConditionalExpression::ConditionalExpression(const Token::TokenPosition &position, Expression::expression_t condition, Expression::expression_t truthy, Expression::expression_t falsy) : Expression(position), condition(std::move(condition)), truthy(std::move(truthy)), falsy(std::move(falsy)) {}
 
 Value::value_t ConditionalExpression::operator ()(ProgramState& state) const {
-    if((bool)*((*condition)(state))){
+    if((bool)(*condition)(state)){
         return (*truthy)(state);
     } else {
         return (*falsy)(state);
     }
+}
+
+Value::value_t ConditionalExpression::tail(ProgramState& state, TailCall &call) const {
+    if((bool)(*condition)(state)){
+        return truthy->tail(state, call);
+    } else {
+        return falsy->tail(state, call);
+    }
+}
+
+Expression::expression_t ConditionalExpression::fold(){
+    optimize(condition);
+    optimize(truthy);
+    optimize(falsy);
+
+    if(const Value::value_t *literal = condition->literal()){
+        return (bool)*literal ? truthy : falsy;
+    }
+
+    return nullptr;
+}
+
+bool ConditionalExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    return condition->pure(bound) && truthy->pure(bound) && falsy->pure(bound);
+}
+
+bool ConditionalExpression::tail_calls() const noexcept {
+    return truthy->tail_calls() || falsy->tail_calls();
+}
+
+void ConditionalExpression::compile(vm::Compiler &compiler) const {
+    condition->compile(compiler);
+    const std::size_t to_falsy = compiler.emit(vm::OpCode::jump_if_false, 0, position);
+
+    truthy->compile(compiler);
+    const std::size_t to_end = compiler.emit(vm::OpCode::jump, 0, position);
+
+    compiler.patch(to_falsy);
+    falsy->compile(compiler);
+
+    compiler.patch(to_end);
+}
+
+void ConditionalExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::conditional, position);
+    condition->serialize(writer);
+    truthy->serialize(writer);
+    falsy->serialize(writer);
 }
\ No newline at end of file
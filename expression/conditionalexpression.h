@@ -29,6 +29,39 @@ struct ConditionalExpression : public Expression {
         **/
         Value::value_t operator ()(ProgramState&) const;
 
+        /**
+         *  @brief evaluate condition, then the chosen path in tail position
+         *  @param state of program
+         *  @param call see Expression::tail
+        **/
+        Value::value_t tail(ProgramState&, TailCall&) const;
+
+        /**
+         *  @brief emit condition followed by both paths joined with jumps
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief fold all three expressions, a literal condition is replaced by the path it would take
+        **/
+        expression_t fold();
+
+        /**
+         *  @brief pure if condition and both paths are pure
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
+
+        /**
+         *  @brief either path is in tail position
+        **/
+        bool tail_calls() const noexcept;
+
     private:
         Expression::expression_t condition, truthy, falsy;  // used to store the expressions of respective names
 };
@@ -1,7 +1,31 @@
 #include "defineexpression.h"
 
-DefineExpression::DefineExpression(const Token::TokenPosition& position, const std::string& name, expression_t value) : Expression(position), name(name), value(std::move(value)) {}
+#include "lambdaexpression.h"   // defines LambdaExpression::define used to fold the value
+#include "../vm/compiler.h"     // defines vm::Compiler
+#include "../cache/astcache.h"  // defines cache::Writer
+
+DefineExpression::DefineExpression(const Token::TokenPosition& position, ProgramState::slot_t slot, expression_t value) : Expression(position), slot(slot), value(std::move(value)) {}
 
 Value::value_t DefineExpression::operator ()(ProgramState& state) const {
-    return state.set(name, (*value)(state));
+    return state.set(slot, (*value)(state));
+}
+
+Expression::expression_t DefineExpression::fold(){
+    LambdaExpression::define(slot, value);
+    return nullptr;
+}
+
+bool DefineExpression::pure(std::vector<ProgramState::slot_t>&) const {
+    return false;
+}
+
+void DefineExpression::compile(vm::Compiler &compiler) const {
+    value->compile(compiler);
+    compiler.emit(vm::OpCode::define, slot, position);
+}
+
+void DefineExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::define, position);
+    writer.name(slot);
+    value->serialize(writer);
 }
\ No newline at end of file
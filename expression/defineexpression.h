@@ -11,12 +11,23 @@
 
 struct DefineExpression : public Expression {
     public:
-        DefineExpression(const Token::TokenPosition&, const std::string&, expression_t);
+        DefineExpression(const Token::TokenPosition&, ProgramState::slot_t, expression_t);
 
         Value::value_t operator ()(ProgramState&) const;
+
+        void compile(vm::Compiler&) const;
+
+        void serialize(cache::Writer&) const;
+
+        expression_t fold();
+
+        /**
+         *  @brief defines are never pure
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
     
     private:
-        const std::string name;
+        const ProgramState::slot_t slot;   // slot of reference name being defined
         expression_t value;
 };
 
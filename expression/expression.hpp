@@ -10,14 +10,29 @@
 #include "../value/value.hpp"           // defines Value which is used to represent a loosely typed value of any of Fragment's base value types
 #include "../datatype/token.hpp"        // defines Token::TokenPosition used to represent starting position of expression in the file
 #include "../datatype/programstate.h"   // defines ProgramState for adding state to otherwise stateless expressions
+#include "../datatype/smallvector.hpp"  // defines SmallVector used to hold the arguments of a TailCall
+#include "../datatype/refcounted.hpp"   // defines RefCounted and Ref used to share expressions
 
-#include <memory>   // defines std::unqiue_ptr for managing expressions
+#include <vector>   // defines std::vector used to pass bound parameters to Expression::pure
+
+namespace vm { class Compiler; }    // forward declare vm::Compiler (see vm/compiler.h) so expressions can compile themselves
+namespace cache { class Writer; }   // forward declare cache::Writer (see cache/astcache.h) so expressions can serialize themselves
+
+/**
+ *  @brief a call to a lambda in tail position, handed back to the lambda that is running so it can make the call without recursing
+ *  @desc see Expression::tail and LambdaExpression::Closure
+**/
+struct TailCall {
+    Value::value_t function;                    // function to call, only set if pending
+    SmallVector<Value::value_t, 4> arguments;   // arguments to call function with
+    bool pending = false;                       // true if the call still has to be made
+};
 
 /**
  *  @brief represents a code expression
 **/
-struct Expression {
-    typedef std::shared_ptr<Expression> expression_t;   // allows for calls to overloaded functions in a memory safe way
+struct Expression : public RefCounted {
+    typedef Ref<Expression> expression_t;   // allows for calls to overloaded functions in a memory safe way
 
     Token::TokenPosition position;  // stores file position of first token in expression
 
@@ -32,6 +47,89 @@ struct Expression {
      *  @return value representing the value of the expression (note that not all expressions are pure)
     **/
     virtual Value::value_t operator ()(ProgramState&) const = 0;
+
+    /**
+     *  @brief evaluate expression in tail position of a lambda body
+     *  @desc a call to a lambda that would be the last thing evaluated may instead be stored in call (setting call.pending) and left to the caller
+     *        expressions that never make calls in tail position simply evaluate themselves
+     *  @param state of program
+     *  @param call set to the call that still has to be made, if any
+     *  @return value of expression (meaningless if call.pending is set)
+    **/
+    inline virtual Value::value_t tail(ProgramState &state, TailCall&) const {
+        return (*this)(state);
+    }
+
+    /**
+     *  @brief constant fold subexpressions in place, then this expression if possible
+     *  @desc only operators over literal values (and whatever depends only on them) fold, they are computed with the same operators used at runtime so weak typing rules are kept
+     *  @return replacement for this expression, or nullptr to keep it
+    **/
+    inline virtual expression_t fold() {
+        return nullptr;
+    }
+
+    /**
+     *  @brief get value of expression if it is a literal
+     *  @return pointer to value, or nullptr if expression is not a literal
+    **/
+    inline virtual const Value::value_t* literal() const noexcept {
+        return nullptr;
+    }
+
+    /**
+     *  @brief get slot of expression if it is a reference
+     *  @return pointer to slot, or nullptr if expression is not a reference
+    **/
+    inline virtual const ProgramState::slot_t* slot() const noexcept {
+        return nullptr;
+    }
+
+    /**
+     *  @brief check that evaluating the expression has no side effects and only depends on the parameters it is given
+     *  @desc a pure expression defines nothing and only reads references in bound
+     *        function expressions may only call parameters, the lambda being defined, or references known to hold pure functions (see LambdaExpression::callable)
+     *  @param bound parameter slots of every lambda the expression is inside of
+    **/
+    virtual bool pure(std::vector<ProgramState::slot_t>&) const = 0;
+
+    /**
+     *  @brief check if evaluating the expression gives a function whose body was proven pure when it was folded (see LambdaExpression::fold)
+    **/
+    inline virtual bool pure_function() const noexcept {
+        return false;
+    }
+
+    /**
+     *  @brief check if expression may make a call in tail position (see Expression::tail)
+    **/
+    inline virtual bool tail_calls() const noexcept {
+        return false;
+    }
+
+    /**
+     *  @brief fold expression (see Expression::fold), replacing it if the whole expression folds
+     *  @param expression to optimize
+    **/
+    static inline void optimize(expression_t &expression){
+        if(expression_t folded = expression->fold()){
+            expression = std::move(folded);
+        }
+    }
+
+    /**
+     *  @brief enforces that all expression subclasses can be lowered into bytecode for vm::Machine
+     *  @desc appends instructions that leave exactly one value (the value of the expression) on the machine stack
+     *  @param compiler to emit instructions into
+    **/
+    virtual void compile(vm::Compiler&) const = 0;
+
+    /**
+     *  @brief enforces that all expression subclasses can be written to a precompiled cache file
+     *  @desc writes a node (see cache::Tag) for the expression followed by its fields and subexpressions, must be called before the expression is folded
+     *  @param writer to write into
+    **/
+    virtual void serialize(cache::Writer&) const = 0;
 };
 
 #endif
\ No newline at end of file
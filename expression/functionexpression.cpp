@@ -1,6 +1,10 @@
 #include "functionexpression.h"
 
 #include "invalidexpression.hpp"    // defines InvalidExpression exception
+#include "../vm/compiler.h"         // defines vm::Compiler
+#include "../cache/astcache.h"     // defines cache::Writer
+
+#include <algorithm>                // defines std::all_of used to check purity
 
 FunctionExpression::FunctionExpression(const Token::TokenPosition &position, Expression::expression_t function, std::list<Expression::expression_t> arguments) : Expression(position), function(function), arguments(std::move(arguments)) {
     if(!this->arguments.size()){
@@ -8,18 +12,122 @@ FunctionExpression::FunctionExpression(const Token::TokenPosition &position, Exp
     }
 }
 
-Value::value_t FunctionExpression::operator ()(ProgramState& state) const {
+FunctionExpression::CacheStatistics FunctionExpression::statistics;
+
+Value::value_t FunctionExpression::callee(ProgramState& state, const LambdaExpression::Closure *&closure) const {
+    // call sites are shared by every thread, so only the main (not layered) state uses the cache
+    const ProgramState::slot_t *slot = state.layered() ? nullptr : function->slot();
+
+    if(slot){
+        const std::uint64_t version = state.version(*slot);
+        if(version && version == cache.version){
+            ++statistics.hits;
+            closure = cache.closure;
+            return cache.function;
+        }
+        ++statistics.misses;
+    }
+
     Value::value_t f = (*function)(state);
 
-    if(f->type != ValueType::function){
-        throw InvalidExpression(position, "Expected function at start of function expression, got " + to_string(f->type));
+    if(f.type() != ValueType::function){
+        throw InvalidExpression(position, "Expected function at start of function expression, got " + to_string(f.type()));
     }
 
-    std::list<Value::value_t> values;
+    closure = f.function().target<LambdaExpression::Closure>();
+    if(closure && closure->parameters.size() != arguments.size()){
+        // let the call report the wrong number of arguments
+        closure = nullptr;
+    }
+
+    if(slot){
+        cache = CallCache{state.version(*slot), f, closure};
+    }
+
+    return f;
+}
+
+Value::value_t FunctionExpression::operator ()(ProgramState& state) const {
+    const LambdaExpression::Closure *closure;
+    Value::value_t f = callee(state, closure);
+
+    SmallVector<Value::value_t, 4> values;
 
     for(const auto &argument : arguments){
         values.push_back((*argument)(state));
     }
+
+    if(closure){
+        return closure->invoke(values);
+    }
     
-    return (std::get<std::function<Value::value_t(std::list<Value::value_t>)>>(f->value))(std::move(values));
+    return f.function()(values);
+}
+
+Value::value_t FunctionExpression::tail(ProgramState& state, TailCall &call) const {
+    const LambdaExpression::Closure *closure;
+    Value::value_t f = callee(state, closure);
+
+    SmallVector<Value::value_t, 4> values;
+
+    for(const auto &argument : arguments){
+        values.push_back((*argument)(state));
+    }
+
+    if(!closure){
+        return f.function()(values);
+    }
+
+    call.function = std::move(f);
+    call.arguments = std::move(values);
+    call.pending = true;
+    return Value::value_t();
+}
+
+Expression::expression_t FunctionExpression::fold(){
+    optimize(function);
+
+    for(auto &argument : arguments){
+        optimize(argument);
+    }
+
+    return nullptr;
+}
+
+bool FunctionExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    // anything a reference may hold could print, read input, or read a reference that changes, unless it is known to be pure
+    if(const ProgramState::slot_t *slot = function->slot()){
+        if(!LambdaExpression::callable(*slot, bound)){
+            return false;
+        }
+    } else if(!function->pure(bound)){
+        return false;
+    }
+
+    return std::all_of(arguments.begin(), arguments.end(), [&bound](const expression_t &argument){ return argument->pure(bound); });
+}
+
+bool FunctionExpression::tail_calls() const noexcept {
+    return true;
+}
+
+void FunctionExpression::compile(vm::Compiler &compiler) const {
+    function->compile(compiler);
+    compiler.emit(vm::OpCode::expect_function, 0, position);
+
+    for(const auto &argument : arguments){
+        argument->compile(compiler);
+    }
+
+    compiler.emit(vm::OpCode::call, arguments.size(), position);
+}
+
+void FunctionExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::function, position);
+    function->serialize(writer);
+
+    writer.count(arguments.size());
+    for(const auto &argument : arguments){
+        argument->serialize(writer);
+    }
 }
\ No newline at end of file
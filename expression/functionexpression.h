@@ -7,12 +7,24 @@
 #ifndef EXPRESSION_FUNCTIONEXPRESSION_H
 #define EXPRESSION_FUNCTIONEXPRESSION_H
 
-#include "expression.hpp"   // defines Expression
+#include "expression.hpp"       // defines Expression
+#include "lambdaexpression.h"   // defines LambdaExpression::Closure remembered by the call site cache
 
-#include <list>             // defines std::list for storing arguments
+#include <cstdint>              // defines std::uint64_t used for cache versions and statistics
+#include <list>                 // defines std::list for storing arguments
 
 struct FunctionExpression : public Expression {
     public:
+        /**
+         *  @brief hit rate of every call site cache (see FunctionExpression::CallCache), printed by --cache-stats
+        **/
+        struct CacheStatistics {
+            std::uint64_t hits = 0;     // calls that reused the cached function
+            std::uint64_t misses = 0;   // calls through a reference that had to look the function up
+        };
+
+        static CacheStatistics statistics;
+
         /**
          *  @brief create function expression for given function
          *  @param position of first token
@@ -27,9 +39,62 @@ struct FunctionExpression : public Expression {
         **/
         Value::value_t operator ()(ProgramState&) const;
 
+        /**
+         *  @brief evaluate function and arguments, leaving a call to a lambda to the caller
+         *  @param state of program
+         *  @param call see Expression::tail
+        **/
+        Value::value_t tail(ProgramState&, TailCall&) const;
+
+        /**
+         *  @brief emit function, arguments, and a call instruction
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief fold function and arguments, calls themselves are never folded
+        **/
+        expression_t fold();
+
+        /**
+         *  @brief pure if arguments are pure and function is either pure or a reference that may be called (see LambdaExpression::callable)
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
+
+        /**
+         *  @brief always a call
+        **/
+        bool tail_calls() const noexcept;
+
     private:
+        /**
+         *  @brief monomorphic inline cache for calls through a reference (for example (f x) but not ((g) x))
+         *  @desc valid while the version of the slot (see ProgramState::version) is the one recorded, that only changes when the reference is set again
+         *        not used by layered states (see frstd::pmap), which may run on several threads at once
+        **/
+        struct CallCache {
+            std::uint64_t version = 0;                              // version of the binding function was read from, 0 if empty
+            Value::value_t function;                                // function the reference held
+            const LambdaExpression::Closure *closure = nullptr;     // target of function if it is a lambda accepting exactly as many arguments as this call passes
+        };
+
+        /**
+         *  @brief evaluate function (or reuse the cached one), checking that it is a function
+         *  @param state of program
+         *  @param closure set to a lambda that can be called without checking the number of arguments, or nullptr
+         *  @throws InvalidExpression if function does not evaluate to a function
+        **/
+        Value::value_t callee(ProgramState&, const LambdaExpression::Closure*&) const;
+
         Expression::expression_t function;
         std::list<Expression::expression_t> arguments;
+        mutable CallCache cache;
 };
 
 #endif
\ No newline at end of file
@@ -2,32 +2,214 @@
 
 #include "../value/functionvalue.h"
 #include "../value/notimplemented.hpp"
+#include "../vm/compiler.h"
+#include "../cache/astcache.h"
 
-LambdaExpression::LambdaExpression(const Token::TokenPosition &position, std::list<std::string> parameters, expression_t body) : Expression(position), parameters(std::move(parameters)), body(std::move(body)) {}
+#include <algorithm>    // defines std::find used to find parameters, and std::sort and std::unique used to list calls once
+
+bool LambdaExpression::auto_memoize = false;
+std::unordered_map<ProgramState::slot_t, LambdaExpression::Definition> LambdaExpression::functions;
+const Expression *LambdaExpression::defining = nullptr;
+ProgramState::slot_t LambdaExpression::defining_slot = 0;
+const ProgramState::slot_t *LambdaExpression::recursive = nullptr;
+std::vector<ProgramState::slot_t> *LambdaExpression::calls = nullptr;
+
+LambdaExpression::LambdaExpression(const Token::TokenPosition &position, std::vector<ProgramState::slot_t> parameters, expression_t body) : Expression(position), parameters(std::move(parameters)), body(std::move(body)), proven(false), memoized(false) {}
 
 Value::value_t LambdaExpression::operator ()(ProgramState &state) const {
-    return Value::value_t(new FunctionValue([&state, *this](std::list<Value::value_t> parameters) -> Value::value_t {
-        if(parameters.size() != this->parameters.size()){
-            throw NotImplemented("Attempt to call function with incorrect number of parameters");
+    if(memoized){
+        return Value::value_t::make<FunctionValue>(Closure{&state, parameters, body, std::make_shared<frstd::MemoCache>(frstd::MemoCache::default_capacity, stale)});
+    }
+    return Value::value_t::make<FunctionValue>(Closure{&state, parameters, body, nullptr});
+}
+
+void LambdaExpression::Closure::bind(ProgramState &state, Value::arguments_t arguments) const {
+    if(arguments.size() != parameters.size()){
+        throw NotImplemented("Attempt to call function with incorrect number of parameters");
+    }
+
+    auto values = arguments.begin();
+
+    for(const ProgramState::slot_t slot : parameters){
+        state.set(slot, *values);
+        ++values;
+    }
+}
+
+Value::value_t LambdaExpression::Closure::operator ()(Value::arguments_t arguments) const {
+    if(arguments.size() != parameters.size()){
+        throw NotImplemented("Attempt to call function with incorrect number of parameters");
+    }
+
+    return invoke(arguments);
+}
+
+Value::value_t LambdaExpression::Closure::invoke(Value::arguments_t arguments) const {
+    // on worker threads (see frstd::pmap) this runs in the state of the worker, whatever state the lambda was created in
+    ProgramState &state = ProgramState::current ? *ProgramState::current : *this->state;
+
+    frstd::MemoCache::key_t key;
+    const bool cached = cache && cache->key(arguments, key);
+    if(cached){
+        Value::value_t result;
+        if(cache->find(key, result)){
+            return result;
+        }
+    }
+
+    state.push();
+
+    auto values = arguments.begin();
+    for(const ProgramState::slot_t slot : parameters){
+        state.set(slot, *values);
+        ++values;
+    }
+
+    TailCall call;
+    Value::value_t value = body->tail(state, call);
+
+    // keep making calls left in tail position, each reuses this scope instead of pushing its own
+    Value::value_t function;    // keeps the closure currently running alive
+    while(call.pending){
+        function = std::move(call.function);
+        call.pending = false;
+
+        const Closure &closure = *function.function().target<Closure>();
+        if(closure.cache){
+            // memoized lambdas make no calls in tail position, so this ends the loop
+            value = closure.invoke(call.arguments);
+            continue;
+        }
+
+        closure.bind(state, call.arguments);
+        value = closure.body->tail(state, call);
+    }
+
+    state.pop();
+
+    if(cached){
+        cache->insert(std::move(key), value);
+    }
+
+    return value;
+}
+
+Expression::expression_t LambdaExpression::fold(){
+    // read before the body is folded, defines inside of it change what is being defined
+    const bool named = defining == this;
+    const ProgramState::slot_t name = defining_slot;
+
+    optimize(body);
+
+    std::vector<ProgramState::slot_t> called;
+    if(auto_memoize){
+        const ProgramState::slot_t *outer = recursive;
+        std::vector<ProgramState::slot_t> *outer_calls = calls;
+        recursive = named ? &name : nullptr;
+        calls = &called;
+
+        std::vector<ProgramState::slot_t> bound(parameters);
+        proven = body->pure(bound);
+
+        recursive = outer;
+        calls = outer_calls;
+    }
+
+    // calls in tail position are loops (see Closure), memoizing them would only make them recurse
+    memoized = proven && !body->tail_calls();
+
+    if(proven && named){
+        // lambdas that call this one once it is defined depend on everything it calls
+        functions[name].calls = called;
+    }
+
+    std::sort(called.begin(), called.end());
+    called.erase(std::unique(called.begin(), called.end()), called.end());
+
+    if(memoized && !called.empty()){
+        stale = std::make_shared<std::atomic<bool>>(false);
+        for(const ProgramState::slot_t slot : called){
+            functions[slot].callers.push_back(stale);
+        }
+    }
+
+    return nullptr;
+}
+
+bool LambdaExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    bound.insert(bound.end(), parameters.begin(), parameters.end());
+    const bool result = body->pure(bound);
+    bound.resize(bound.size() - parameters.size());
+    return result;
+}
+
+bool LambdaExpression::pure_function() const noexcept {
+    return proven;
+}
+
+void LambdaExpression::define(ProgramState::slot_t slot, expression_t &value){
+    // references to elements of an unordered_map stay valid while others are added
+    Definition &definition = functions[slot];
+
+    // redefining a function, even to another pure one, changes what lambdas that call it compute
+    const bool first = !definition.defined;
+    if(!first){
+        definition.pure = false;
+        for(const auto &caller : definition.callers){
+            caller->store(true, std::memory_order_relaxed);
         }
+        definition.callers.clear();
+    }
+    definition.defined = true;
 
-        state.push();
+    const Expression *outer = defining;
+    const ProgramState::slot_t outer_slot = defining_slot;
 
-        auto values = parameters.begin();
+    defining = value.get();
+    defining_slot = slot;
+    optimize(value);
 
-        auto names = this->parameters.begin();
-        const auto end = this->parameters.end();
+    defining = outer;
+    defining_slot = outer_slot;
 
-        while(names != end){
-            state.set(*names, *values);
-            ++names;
-            ++values;
+    definition.pure = first && value->pure_function();
+}
+
+bool LambdaExpression::callable(ProgramState::slot_t slot, const std::vector<ProgramState::slot_t> &bound){
+    if(std::find(bound.begin(), bound.end(), slot) != bound.end()){
+        return true;
+    }
+
+    if(recursive && *recursive == slot){
+        if(calls){
+            calls->push_back(slot);
         }
+        return true;
+    }
+
+    const auto found = functions.find(slot);
+    if(found == functions.end() || !found->second.pure){
+        return false;
+    }
+
+    if(calls){
+        calls->push_back(slot);
+        calls->insert(calls->end(), found->second.calls.begin(), found->second.calls.end());
+    }
+    return true;
+}
+
+void LambdaExpression::compile(vm::Compiler &compiler) const {
+    compiler.emit(vm::OpCode::make_lambda, compiler.lambda(parameters, *body, memoized, stale), position);
+}
 
-        Value::value_t value = (*body)(state);
+void LambdaExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::lambda, position);
 
-        state.pop();
+    writer.count(parameters.size());
+    for(const ProgramState::slot_t parameter : parameters){
+        writer.name(parameter);
+    }
 
-        return value;
-    }));
+    body->serialize(writer);
 }
\ No newline at end of file
@@ -7,22 +7,64 @@
 #ifndef EXPRESSION_LAMBDAEXPRESSION_H
 #define EXPRESSION_LAMBDAEXPRESSION_H
 
-#include "expression.hpp"   // defines Expression
+#include "expression.hpp"           // defines Expression
+#include "../utility/memoize.h"     // defines frstd::MemoCache used by memoized lambdas
 
-#include <list>             // used to represent a collection of paramater names
+#include <atomic>                   // defines std::atomic used to mark results of memoized lambdas stale
+#include <memory>                   // defines std::shared_ptr used to share caches and stale flags
+#include <unordered_map>            // defines std::unordered_map used to remember which slots hold pure functions
+#include <vector>                   // used to store parameter slots
 
 /**
  *  @brief represents a nameless function as an expression 
 **/
 struct LambdaExpression : public Expression {
     public:
+        /**
+         *  @brief callable stored inside of FunctionValue for every lambda created by the tree walking interpeter
+         *  @desc calls in tail position of the body (see Expression::tail) are run in a loop inside of the same scope
+         *        parameters of the next call are bound over the current ones, so tail recursion runs in constant native stack and scope memory
+         *        memoized lambdas look calls up in their cache right here, a wrapper around the closure would add native frames to every recursive call
+        **/
+        struct Closure {
+            ProgramState *state;                            // state the lambda was created in, used unless ProgramState::current is set
+            std::vector<ProgramState::slot_t> parameters;   // slots of the parameters the function accepts
+            expression_t body;                              // body of function
+            std::shared_ptr<frstd::MemoCache> cache;        // results of calls if the lambda is memoized (see LambdaExpression::auto_memoize), otherwise nullptr
+
+            /**
+             *  @brief call lambda
+             *  @param arguments to bind to parameters
+             *  @throws NotImplemented if the number of arguments is wrong
+             *  @return result of evaluating body
+            **/
+            Value::value_t operator ()(Value::arguments_t) const;
+
+            /**
+             *  @brief call lambda without checking the number of arguments (used by call sites that already checked it, see FunctionExpression)
+             *  @param arguments to bind to parameters, must be exactly as many as there are parameters
+             *  @return result of evaluating body
+            **/
+            Value::value_t invoke(Value::arguments_t) const;
+
+            /**
+             *  @brief bind arguments to parameters in the current scope
+             *  @param state to bind parameters in
+             *  @param arguments to bind
+             *  @throws NotImplemented if the number of arguments is wrong
+            **/
+            void bind(ProgramState&, Value::arguments_t) const;
+        };
+
+        static bool auto_memoize;   // if true lambdas whose bodies are pure and make no calls in tail position are memoized (see --memo=auto)
+
         /**
          *  @brief create a lambda expression
          *  @param position of first token
-         *  @param parameters the function accepts
+         *  @param parameters slots (see ProgramState::resolve) of the parameters the function accepts
          *  @param body of expression 
         **/
-        LambdaExpression(const Token::TokenPosition&, std::list<std::string>, expression_t);
+        LambdaExpression(const Token::TokenPosition&, std::vector<ProgramState::slot_t>, expression_t);
 
         /**
          *  @brief access the underlying function value_t
@@ -30,9 +72,73 @@ struct LambdaExpression : public Expression {
         **/
         Value::value_t operator ()(ProgramState&) const;
 
+        /**
+         *  @brief compile body into its own chunk and emit instruction to create function value
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief fold body, then decide if the lambda is memoized (see LambdaExpression::auto_memoize)
+         *  @desc a lambda that is the value of a define may call itself and still be pure (see LambdaExpression::define)
+        **/
+        expression_t fold();
+
+        /**
+         *  @brief creating a lambda is pure if its body is pure (with its parameters bound)
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
+
+        /**
+         *  @brief true if the body was proven pure when folded (only checked with auto_memoize)
+        **/
+        bool pure_function() const noexcept;
+
+        /**
+         *  @brief fold the value of a define, and remember if the slot now holds a pure function
+         *  @desc redefining a slot marks the results of every memoized lambda that calls it (directly or not) stale, so they stop memoizing
+         *  @param slot being defined
+         *  @param value of define, folded in place
+        **/
+        static void define(ProgramState::slot_t, expression_t&);
+
+        /**
+         *  @brief check if a pure body may call the function a reference holds
+         *  @desc true for parameters (calls with function arguments are never memoized, see frstd::Memoized), for the lambda being defined,
+         *        and for references that were defined exactly once so far, to a lambda proven pure
+         *        the lambda being defined and references are remembered as called by the lambda being checked (see LambdaExpression::define)
+         *  @param slot of called reference
+         *  @param bound parameter slots of every lambda the call is inside of
+        **/
+        static bool callable(ProgramState::slot_t, const std::vector<ProgramState::slot_t>&);
+
     private:
-        const std::list<std::string> parameters;  // represents the parameters the function accepts
-        const expression_t body;                  // represents body of function
+        const std::vector<ProgramState::slot_t> parameters;    // represents the slots of the parameters the function accepts
+        expression_t body;                                      // represents body of function
+        bool proven;                                            // body was proven pure when folded
+        bool memoized;                                          // closures cache their results
+        std::shared_ptr<std::atomic<bool>> stale;               // set once a function the body calls is redefined, nullptr if it calls none
+
+        /**
+         *  @brief what is known about a slot that was defined
+        **/
+        struct Definition {
+            bool defined = false;                                   // defined at least once
+            bool pure = false;                                      // defined exactly once, to a lambda proven pure
+            std::vector<ProgramState::slot_t> calls;                // slots the lambda calls, directly or through other pure functions
+            std::vector<std::shared_ptr<std::atomic<bool>>> callers;    // stale flags of memoized lambdas that call the slot
+        };
+
+        static std::unordered_map<ProgramState::slot_t, Definition> functions;  // every slot defined so far
+        static const Expression *defining;                                      // value of the define being folded, if any
+        static ProgramState::slot_t defining_slot;                              // slot of the define being folded
+        static const ProgramState::slot_t *recursive;                           // slot the body being checked may call itself through, or nullptr
+        static std::vector<ProgramState::slot_t> *calls;                        // slots the body being checked calls, or nullptr
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,40 @@
 #include "operatorexpression.h"
 
-#include "invalidexpression.hpp"    // defines InvalidExpression for reporting errors
+#include "invalidexpression.hpp"        // defines InvalidExpression for reporting errors
+#include "atomicexpression.h"           // defines AtomicExpression used to replace folded expressions
+#include "../value/notimplemented.hpp"  // defines NotImplemented for reporting an unknown operator outside of an expression
+#include "../vm/compiler.h"             // defines vm::Compiler
+#include "../cache/astcache.h"         // defines cache::Writer
+
+#include <algorithm>                    // defines std::all_of used to check purity
+
+namespace {
+
+// operation applied by each OperatorType, in order of declaration
+constexpr dispatch::Operation operations[] = {
+    dispatch::Operation::add,
+    dispatch::Operation::subtract,
+    dispatch::Operation::multiply,
+    dispatch::Operation::divide,
+    dispatch::Operation::less,
+    dispatch::Operation::greater,
+    dispatch::Operation::less_equal,
+    dispatch::Operation::greater_equal,
+    dispatch::Operation::logical_and,
+    dispatch::Operation::logical_or,
+    dispatch::Operation::logical_not
+};
+
+static_assert(sizeof(operations) / sizeof(*operations) == static_cast<std::size_t>(OperatorExpression::OperatorType::operator_not) + 1, "every operator needs an operation");
+
+} // end of anonymous namespace
 
 OperatorExpression::OperatorExpression(const Token::TokenPosition& position, OperatorType type, std::list<Expression::expression_t> arguments) : Expression(position), type(type), arguments(std::move(arguments)) {
+    if(type > OperatorType::operator_not){
+        throw InvalidExpression(position, "Invalid Operator (possibly a parsing error)");
+    }
+    operation = operations[static_cast<std::size_t>(type)];
+
     if(!this->arguments.size()){
         throw InvalidExpression(position, "All operators require at least one arguments");
     } else if(type == OperatorExpression::OperatorType::operator_not && this->arguments.size() != 1){
@@ -11,56 +43,104 @@ OperatorExpression::OperatorExpression(const Token::TokenPosition& position, Ope
 }
 
 Value::value_t OperatorExpression::operator ()(ProgramState& state) const {
-    using optype = OperatorExpression::OperatorType;
-    using value_t = Value::value_t;
-
-    if(type == optype::operator_not){
+    if(type == OperatorType::operator_not){
         // ensured that only one argument, special case
         return !(*arguments.front())(state);
     }
 
-    // similar to std::accumulate, but specialized for this
-    const auto accumulate = [&state](auto start, const auto end, auto op) -> value_t {
-        value_t base = (**start)(state);
-        for(++start; start != end; ++start){
-            base = op(base, (**start)(state));
+    // left fold, every step goes straight to the kernel for the types of its operands
+    auto argument = arguments.begin();
+    Value::value_t base = (**argument)(state);
+    for(++argument; argument != arguments.end(); ++argument){
+        const Value::value_t value = (**argument)(state);
+        base = dispatch::kernel(operation, base.type(), value.type())(base, value);
+    }
+    return base;
+}
+
+dispatch::Operation OperatorExpression::to_operation(OperatorType type){
+    if(type > OperatorType::operator_not){
+        throw NotImplemented("Invalid Operator (possibly a parsing error)");
+    }
+    return operations[static_cast<std::size_t>(type)];
+}
+
+Value::value_t OperatorExpression::apply(OperatorType type, const Value::value_t &a, const Value::value_t &b){
+    if(type == OperatorType::operator_not){
+        return !a;
+    }
+    return dispatch::apply(to_operation(type), a, b);
+}
+
+Expression::expression_t OperatorExpression::fold(){
+    for(auto &argument : arguments){
+        optimize(argument);
+    }
+
+    const Value::value_t *first = arguments.front()->literal();
+    if(!first){
+        return nullptr;
+    }
+
+    Value::value_t base = *first;
+    auto argument = ++arguments.begin();
+
+    try {
+        if(type == OperatorType::operator_not){
+            return expression_t(new AtomicExpression(position, !base));
+        }
+
+        for(; argument != arguments.end(); ++argument){
+            const Value::value_t *value = (*argument)->literal();
+            if(!value){
+                break;
+            }
+            base = apply(type, base, *value);
         }
-        return base;
-    };
-
-    // safe to assume that all operators have at least one argument, and that not has only one
-    switch(type){
-        case optype::operator_add:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a + b; });
-        
-        case optype::operator_subtract:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a - b; });
-        
-        case optype::operator_multiply:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a * b; });
-        
-        case optype::operator_divide:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a / b; });
-        
-        case optype::operator_less:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a < b; });
-        
-        case optype::operator_greater:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a > b; });
-        
-        case optype::operator_less_or_equal:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a <= b; });
-        
-        case optype::operator_greater_or_equal:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a >= b; });
-        
-        case optype::operator_and:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a && b; });
-        
-        case optype::operator_or:
-            return accumulate(arguments.begin(), arguments.end(), [](auto a, auto b){ return a || b; });
-        
-        default:
-            throw InvalidExpression(position, "Invalid Operator (possibly a parsing error)");
+    } catch(...) {
+        // leave the failing operation (and everything after it) to runtime
+    }
+
+    if(argument == arguments.end()){
+        return expression_t(new AtomicExpression(position, std::move(base)));
+    }
+
+    if(argument != ++arguments.begin()){
+        const Token::TokenPosition start = arguments.front()->position;
+        arguments.erase(arguments.begin(), argument);
+        arguments.push_front(expression_t(new AtomicExpression(start, std::move(base))));
+    }
+
+    return nullptr;
+}
+
+bool OperatorExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    return std::all_of(arguments.begin(), arguments.end(), [&bound](const expression_t &argument){ return argument->pure(bound); });
+}
+
+void OperatorExpression::compile(vm::Compiler &compiler) const {
+    if(type == OperatorType::operator_not){
+        arguments.front()->compile(compiler);
+        compiler.emit(vm::OpCode::negate, 0, position);
+        return;
+    }
+
+    // left fold, each argument is evaluated right before it is applied (same as accumulate in operator ())
+    auto argument = arguments.begin();
+    (*argument)->compile(compiler);
+
+    for(++argument; argument != arguments.end(); ++argument){
+        (*argument)->compile(compiler);
+        compiler.emit(vm::OpCode::operate, (std::uint32_t)operation, position);
+    }
+}
+
+void OperatorExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::operation, position);
+    writer.count(static_cast<std::size_t>(type));
+
+    writer.count(arguments.size());
+    for(const auto &argument : arguments){
+        argument->serialize(writer);
     }
 }
\ No newline at end of file
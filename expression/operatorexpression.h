@@ -7,7 +7,10 @@
 #ifndef EXPRESSION_OPERATOREXPRESSION_H
 #define EXPRESSION_OPERATOREXPRESSION_H
 
-#include "expression.hpp"   // defines Expression base class
+#include "expression.hpp"           // defines Expression base class
+#include "../value/dispatch.h"      // defines dispatch::Operation which operators are applied with
+
+#include <list>                     // defines std::list used to store arguments
 
 /**
  *  @brief represents an expression with an operator and some arguments 
@@ -44,9 +47,49 @@ struct OperatorExpression : public Expression {
          *  @param state of program 
         **/
         Value::value_t operator ()(ProgramState&) const;
+
+        /**
+         *  @brief emit arguments interleaved with operate instructions (same evaluation order as operator ())
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief get the operation of the dispatch table an operator applies
+         *  @param type of operator
+        **/
+        static dispatch::Operation to_operation(OperatorType);
+
+        /**
+         *  @brief apply a single binary operator (or negation, ignoring b) to two values
+         *  @param type of operation to perform
+         *  @param a left hand side
+         *  @param b right hand side
+         *  @return result of a (type) b
+        **/
+        static Value::value_t apply(OperatorType, const Value::value_t&, const Value::value_t&);
+
+        /**
+         *  @brief fold arguments, then fold the longest run of literal arguments at the start
+         *  @desc since operators are a left fold, (+ 1 2 x) becomes (+ 3 x) and (+ 1 2) becomes 3
+         *        any application that fails is left alone so that it fails at runtime exactly as before
+         *  @return folded value if every argument folded, otherwise nullptr
+        **/
+        expression_t fold();
+
+        /**
+         *  @brief pure if every argument is pure
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
     
     private:
         OperatorType type;                              // keep track of what kind of operation this represents
+        dispatch::Operation operation;                  // type as an operation of the dispatch table, looked up once
         std::list<Expression::expression_t> arguments;  // arguments to given operation
 };
 
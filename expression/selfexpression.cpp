@@ -1,14 +1,64 @@
 #include "selfexpression.h"
 
+#include "atomicexpression.h"   // defines AtomicExpression used to replace folded expressions
+#include "lambdaexpression.h"   // defines LambdaExpression::Closure which is called in tail position
+#include "../vm/compiler.h"     // defines vm::Compiler
+#include "../cache/astcache.h" // defines cache::Writer
+
 SelfExpression::SelfExpression(const Token::TokenPosition &position, Expression::expression_t value) : Expression(position), value(std::move(value)) {}
 
 Value::value_t SelfExpression::operator ()(ProgramState& state) const {
     Value::value_t unknown = (*value)(state);
 
-    if(unknown->type == ValueType::function){
+    if(unknown.type() == ValueType::function){
         // if function, attempt to evaluate without arguments
-        return (std::get<std::function<Value::value_t(std::list<Value::value_t>)>>(unknown->value))(std::list<Value::value_t>());
+        return unknown.function()(Value::arguments_t());
+    }
+
+    return unknown;
+}
+
+Value::value_t SelfExpression::tail(ProgramState& state, TailCall &call) const {
+    Value::value_t unknown = (*value)(state);
+
+    if(unknown.type() == ValueType::function && unknown.function().target<LambdaExpression::Closure>()){
+        call.function = std::move(unknown);
+        call.arguments.clear();
+        call.pending = true;
+        return Value::value_t();
+    }
+
+    if(unknown.type() == ValueType::function){
+        return unknown.function()(Value::arguments_t());
     }
 
     return unknown;
+}
+
+Expression::expression_t SelfExpression::fold(){
+    optimize(value);
+
+    if(const Value::value_t *literal = value->literal()){
+        return expression_t(new AtomicExpression(position, *literal));
+    }
+
+    return nullptr;
+}
+
+bool SelfExpression::pure(std::vector<ProgramState::slot_t> &bound) const {
+    return value->pure(bound);
+}
+
+bool SelfExpression::tail_calls() const noexcept {
+    return true;
+}
+
+void SelfExpression::compile(vm::Compiler &compiler) const {
+    value->compile(compiler);
+    compiler.emit(vm::OpCode::self, 0, position);
+}
+
+void SelfExpression::serialize(cache::Writer &writer) const {
+    writer.node(cache::Tag::self, position);
+    value->serialize(writer);
 }
\ No newline at end of file
@@ -27,6 +27,39 @@ struct SelfExpression : public Expression {
         **/
         Value::value_t operator ()(ProgramState&) const;
 
+        /**
+         *  @brief evaluate 'self expression', leaving a call to a lambda to the caller
+         *  @param state of program
+         *  @param call see Expression::tail
+        **/
+        Value::value_t tail(ProgramState&, TailCall&) const;
+
+        /**
+         *  @brief emit value followed by self instruction
+         *  @param compiler to emit instructions into
+        **/
+        void compile(vm::Compiler&) const;
+
+        /**
+         *  @brief write expression to a precompiled cache (see Expression::serialize)
+        **/
+        void serialize(cache::Writer&) const;
+
+        /**
+         *  @brief fold value, a literal value (which is never a function) is passed through so the whole expression folds to it
+        **/
+        expression_t fold();
+
+        /**
+         *  @brief pure if value is pure
+        **/
+        bool pure(std::vector<ProgramState::slot_t>&) const;
+
+        /**
+         *  @brief value may be a function that is called
+        **/
+        bool tail_calls() const noexcept;
+
     private:
         Expression::expression_t value;
 };
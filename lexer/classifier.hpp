@@ -0,0 +1,103 @@
+/**
+ *      @file lexer/classifier.hpp
+ *      @brief defines lexer::classify which determines the Token::TokenType of a lexeme
+ *      @author Anastasia Sokol
+ *
+ *      the classifier is a switch over the first character followed by at most one comparison, it never allocates and can run at compile time
+**/
+
+#ifndef LEXER_CLASSIFIER_H
+#define LEXER_CLASSIFIER_H
+
+#include "../datatype/token.hpp"    // defines Token::TokenType which is the result of classification
+
+#include <string_view>              // defines std::string_view used to refer to lexemes
+
+namespace lexer {
+
+/**
+ *  @brief determine what kind of token a lexeme represents
+ *  @param lexeme text of a single lexeme as read by LexStream::LexStreamIterator
+ *  @return type of token, or Token::TokenType::null if lexeme is a malformed string or numeric literal
+**/
+constexpr Token::TokenType classify(const std::string_view lexeme) noexcept {
+    using tt = Token::TokenType;
+
+    if(lexeme.empty()){
+        return tt::null;
+    }
+
+    const bool single = lexeme.length() == 1;
+
+    switch(lexeme[0]){
+        case '(':
+        case ')':
+            return single ? tt::delimiter : tt::reference;
+
+        case '"':
+            // strings cut off by end of file have no closing quotation mark
+            return (lexeme.length() >= 2 && lexeme.back() == '"') ? tt::stringliteral : tt::null;
+
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9': {
+            // valid numeric tokens must be all numeric with optional decimal point
+            bool decimal = false;
+            for(const char character : lexeme){
+                if(character == '.' && !decimal){
+                    decimal = true;
+                } else if(character < '0' || character > '9'){
+                    return tt::null;
+                }
+            }
+            return tt::numeric;
+        }
+
+        case 't':
+            return lexeme == "true" ? tt::boolean : tt::reference;
+
+        case 'f':
+            return lexeme == "false" ? tt::boolean : tt::reference;
+
+        case 'd':
+            return lexeme == "define" ? tt::keyword : tt::reference;
+
+        case 'l':
+            return lexeme == "lambda" ? tt::keyword : tt::reference;
+
+        case 'i':
+            return lexeme == "if" ? tt::keyword : tt::reference;
+
+        case '+':
+        case '-':
+        case '*':
+        case '/':
+        case '=':
+            return single ? tt::operation : tt::reference;
+
+        case '<':
+        case '>':
+            return (single || lexeme == "<=" || lexeme == ">=") ? tt::operation : tt::reference;
+
+        case '%':
+            return lexeme == "%%" ? tt::comment : tt::reference;
+
+        default:
+            return tt::reference;
+    }
+}
+
+// sanity checks, evaluated at compile time
+static_assert(classify("(") == Token::TokenType::delimiter);
+static_assert(classify("\"text\"") == Token::TokenType::stringliteral);
+static_assert(classify("\"text") == Token::TokenType::null);
+static_assert(classify("3.14") == Token::TokenType::numeric);
+static_assert(classify("3.1.4") == Token::TokenType::null);
+static_assert(classify("false") == Token::TokenType::boolean);
+static_assert(classify("lambda") == Token::TokenType::keyword);
+static_assert(classify(">=") == Token::TokenType::operation);
+static_assert(classify("%%") == Token::TokenType::comment);
+static_assert(classify("iffy") == Token::TokenType::reference);
+
+} // end of namespace lexer
+
+#endif
@@ -1,14 +1,14 @@
 #include "lexstream.hpp"
 
 #include "invalidlexeme.hpp"    // defines lexer::InvalidLexeme used to report error turning lexemes into tokens
+#include "classifier.hpp"       // defines lexer::classify used to determine the type of each lexeme
 
-#include <algorithm>            // defines std::all_of and std::any_of for pattern matching
 #include <ios>                  // defines std::ios_base::failure which may be thrown by LexStream::LexStream()
 #include <string>               // defines std::string and std::string_literals::operator ""s which are used to manage lexemes
+#include <string_view>          // defines std::string_view used to refer to lexemes without copying them
 #include <optional>             // defines std::optional which makes reading EOF token strings easier
-#include <vector>               // defines std::vector used as a generic container to wrap initializer list with .begin() and .end() methods
 
-#include <cctype>               // defines std::isspace and std::isdigit for pattern matching
+#include <cctype>               // defines std::isspace for finding the end of lexemes
 
 using std::string_literals::operator ""s;
 using namespace lexer;
@@ -17,7 +17,15 @@ using namespace lexer;
  *  Implimentation of class LexStream
 **/
 
-LexStream::LexStream(const char* const filepath) noexcept(false) : source(unique_file_ptr(std::fopen(filepath, "r"), std::fclose)) {
+LexStream::LexStream(const char* const filepath, SourceMode mode) noexcept(false) : source(nullptr, std::fclose) {
+    if(mode == SourceMode::buffered){
+        // SourceBuffer reports its own errors
+        buffer = std::make_unique<SourceBuffer>(filepath);
+        return;
+    }
+
+    source = unique_file_ptr(std::fopen(filepath, "r"), std::fclose);
+
     // if std::fopen returned nullptr, report error and cancle construction
     if(!source){
         throw std::ios_base::failure("Unable to open file for reading: "s + filepath);
@@ -25,6 +33,10 @@ LexStream::LexStream(const char* const filepath) noexcept(false) : source(unique
 }
 
 LexStream::LexStreamIterator LexStream::begin() noexcept(false) {
+    if(buffer){
+        return LexStream::LexStreamIterator(std::move(buffer));
+    }
+
     return LexStream::LexStreamIterator(std::move(source));
 }
 
@@ -37,7 +49,7 @@ const Token LexStream::end() const noexcept {
  *  Implimentation of nested structure LexStream::LexStreamIterator
 **/
 
-LexStream::LexStreamIterator::LexStreamIterator(unique_file_ptr input) noexcept(false) : input(std::move(input)) {
+LexStream::LexStreamIterator::LexStreamIterator(unique_file_ptr input) noexcept(false) : input(std::move(input)), offset(0) {
     // check if input == nullptr
     if(!this->input){
         throw LexStreamDoubleReadException("Detected attempt to iterate over invalidated LexStream instance, instances are read once!");
@@ -47,7 +59,21 @@ LexStream::LexStreamIterator::LexStreamIterator(unique_file_ptr input) noexcept(
     ++*this;
 }
 
-std::pair<Token::TokenPosition, std::optional<std::string>> LexStream::LexStreamIterator::read_lexeme() noexcept {
+LexStream::LexStreamIterator::LexStreamIterator(std::unique_ptr<SourceBuffer> buffer) noexcept(false) : input(nullptr, std::fclose), buffer(std::move(buffer)), offset(0) {
+    // check if buffer == nullptr
+    if(!this->buffer){
+        throw LexStreamDoubleReadException("Detected attempt to iterate over invalidated LexStream instance, instances are read once!");
+    }
+
+    // set cursor to first token
+    ++*this;
+}
+
+std::pair<Token::TokenPosition, std::optional<std::string_view>> LexStream::LexStreamIterator::read_lexeme() noexcept {
+    return buffer ? read_lexeme_from_buffer() : read_lexeme_from_file();
+}
+
+std::pair<Token::TokenPosition, std::optional<std::string_view>> LexStream::LexStreamIterator::read_lexeme_from_file() noexcept {
     // peek ahead to next value
     const auto peek = [](std::FILE* stream) -> int { int value = getc(stream); ungetc(value, stream); return value; };
 
@@ -101,13 +127,63 @@ std::pair<Token::TokenPosition, std::optional<std::string>> LexStream::LexStream
     const Token::TokenPosition start_position = position;
 
     // get lexeme
-    const std::optional<std::string> lexeme = next(input.get());
+    std::optional<std::string> lexeme = next(input.get());
+
+    if(!lexeme.has_value()){
+        return std::pair<Token::TokenPosition, std::optional<std::string_view>>(start_position, std::nullopt);
+    }
+
+    // tokens only view their text, so keep the lexeme alive for as long as the iterator
+    lexemes.push_back(std::move(lexeme.value()));
 
     // return the combined pair
-    return std::pair<Token::TokenPosition, std::optional<std::string>>(start_position, lexeme);
+    return std::pair<Token::TokenPosition, std::optional<std::string_view>>(start_position, std::string_view(lexemes.back()));
 }
 
-Token LexStream::LexStreamIterator::lexeme_to_token(const std::pair<Token::TokenPosition, std::optional<std::string>> &lexeme) noexcept(false) {
+std::pair<Token::TokenPosition, std::optional<std::string_view>> LexStream::LexStreamIterator::read_lexeme_from_buffer() noexcept {
+    const std::string_view source = buffer->view();
+
+    // values that evaluate to true signify an end to reading
+    const auto is_token_terminator = [](char character) -> bool { return !character || std::isspace(static_cast<unsigned char>(character)) || (character == '(' || character == ')'); };
+
+    // consume a single character and update position
+    const auto read = [this, source]() -> char {
+        const char value = source[offset++];
+        if(value == '\n'){
+            ++this->position.line;
+            this->position.index = 0;
+        } else {
+            ++this->position.index;
+        }
+        return value;
+    };
+
+    // save start position
+    const Token::TokenPosition start_position = position;
+
+    // clear whitespace
+    while(offset < source.size() && std::isspace(static_cast<unsigned char>(source[offset]))){ read(); }
+
+    // signal end of file if applicable
+    if(offset == source.size()){
+        return std::pair<Token::TokenPosition, std::optional<std::string_view>>(start_position, std::nullopt);
+    }
+
+    // read till terminator, lexeme is a slice of the buffer
+    const std::size_t start = offset;
+    const char ch = read();
+
+    if(ch == '"'){
+        while(offset < source.size() && read() != '"');
+    } else if(!is_token_terminator(ch)){
+        while(offset < source.size() && !is_token_terminator(source[offset])){ read(); }
+    }
+
+    // return the combined pair
+    return std::pair<Token::TokenPosition, std::optional<std::string_view>>(start_position, source.substr(start, offset - start));
+}
+
+Token LexStream::LexStreamIterator::lexeme_to_token(const std::pair<Token::TokenPosition, std::optional<std::string_view>> &lexeme) noexcept(false) {
     // early exit if EOF lexeme
     if(!lexeme.second.has_value()){
         return Token("End of File", lexeme.first, Token::TokenType::end_of_file);
@@ -115,37 +191,22 @@ Token LexStream::LexStreamIterator::lexeme_to_token(const std::pair<Token::Token
 
     // easier to use
     const Token::TokenPosition position = lexeme.first;
-    const std::string value = lexeme.second.value();
-
-    // tests if a value is in a list
-    const auto in_set = [value](std::vector<const char*> set) -> bool { return std::any_of(set.begin(), set.end(), [value](auto x) -> bool { return value == x; }); };
-    
-    if(in_set({"(", ")"})){
-        return Token(value, position, Token::TokenType::delimiter);
-    } else if(value[0] == '"'){
-        if(value[value.length() - 1] != '"'){
-            throw InvalidLexeme("Unclosed string, all string literals must end with a closing quotation mark", position);
-        }
+    const std::string_view value = lexeme.second.value();
 
-        return Token(value.substr(1, value.length() - 2), position, Token::TokenType::stringliteral);
-    } else if(std::isdigit(value[0])) {
-        // valid numeric tokens must be all numeric with optional decimal point
-        int8_t allowed_decimals = 1;
-        if(std::all_of(value.begin(), value.end(), [&allowed_decimals](char value) -> bool { return std::isdigit(value) || (value == '.' && !--allowed_decimals); })){
-            return Token(value, position, Token::TokenType::numeric);
-        }
+    const Token::TokenType type = classify(value);
+
+    switch(type){
+        case Token::TokenType::null:
+            if(value[0] == '"'){
+                throw InvalidLexeme("Unclosed string, all string literals must end with a closing quotation mark", position);
+            }
+            throw InvalidLexeme("Only numeric tokens can start with a numeric digit", position);
+
+        case Token::TokenType::stringliteral:
+            return Token(value.substr(1, value.length() - 2), position, type);
 
-        throw InvalidLexeme("Only numeric tokens can start with a numeric digit", position);
-    } else if(in_set({"true", "false"})) {
-        return Token(value, position, Token::TokenType::boolean);
-    } else if(in_set({"define", "lambda", "if"})) {
-        return Token(value, position, Token::TokenType::keyword);
-    } else if(in_set({"+", "-", "*", "/", ">", "<", "=", ">=", "<="})) {
-        return Token(value, position, Token::TokenType::operation);
-    } else if(value == "%%") {
-        return Token(value, position, Token::TokenType::comment);
-    }  else {
-        return Token(value, position, Token::TokenType::reference);
+        default:
+            return Token(value, position, type);
     }
 }
 
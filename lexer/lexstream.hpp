@@ -7,6 +7,9 @@
  *      to check if the stream is still valid (ie, unread) you can use bool LexStream::is_still_valid() or use the LexStream::operator bool() conversion
  *      extended .hpp due to limited use of inline functions
  * 
+ *      by default the whole file is loaded into a SourceBuffer (memory mapped where possible) and tokens are slices of it, nothing is copied
+ *      SourceMode::streamed instead reads one character at a time with getc, which works for any file but must copy every lexeme
+ * 
  *      feature request: have LexStream take a generic character stream so that implimenting unit tests and a possible future standard library (eval ...) function would be simpler
 **/
 
@@ -14,11 +17,14 @@
 #define LEXER_LEXSTREAM_H
 
 #include "../datatype/token.hpp"    // defines structure Token and enum class TokenType
+#include "sourcebuffer.hpp"         // defines SourceBuffer used to hold the whole input file in memory
 
+#include <deque>                    // defines std::deque used to own lexemes read in streamed mode without moving them
 #include <iterator>                 // defines std::input_iterator_tag used to tag LexStream::LexStreamIterator as input iterator
-#include <memory>                   // defines std::unique_ptr used to manage std::FILE* ownership
+#include <memory>                   // defines std::unique_ptr used to manage std::FILE* and SourceBuffer ownership
 #include <stdexcept>                // defines std::runtime_error used for LexStreamDoubleReadException
 #include <string>                   // defines std::string used for lexemes
+#include <string_view>              // defines std::string_view used for lexemes without copying them
 #include <utility>                  // defines std::pair used for pairing position and lexeme data
 #include <optional>                 // defines std::optional used to manage a failure to read a lexeme due to EOF condition
 
@@ -37,8 +43,18 @@ typedef std::unique_ptr<std::FILE, int(*)(std::FILE*)> unique_file_ptr;     // u
  *  however, the class can be moved using std::move
 **/
 class LexStream {
+    public:
+        /**
+         *  @brief how the input file is read
+        **/
+        enum class SourceMode {
+            buffered,   // load entire file up front (memory mapped when possible), tokens refer directly into it
+            streamed    // read file one character at a time with getc, tokens refer into copies of each lexeme
+        };
+
     private:
-        unique_file_ptr source; // represent file, ownership passed to iterator and *never returned* - makes class read once
+        unique_file_ptr source;                 // represent file in streamed mode, ownership passed to iterator and *never returned* - makes class read once
+        std::unique_ptr<SourceBuffer> buffer;   // represent file in buffered mode, ownership passed to iterator and *never returned* - makes class read once
 
     public:
         /**
@@ -62,24 +78,39 @@ class LexStream {
         **/
         struct LexStreamIterator {
             private:
-                unique_file_ptr input;          // represents file, has full ownership
-                Token::TokenPosition position;  // used to keep track of position in file
-                Token cursor;                   // used to store last token read
+                unique_file_ptr input;                  // represents file in streamed mode, has full ownership
+                std::deque<std::string> lexemes;        // owns every lexeme read in streamed mode so tokens can refer to them
+                std::unique_ptr<SourceBuffer> buffer;   // represents file in buffered mode, has full ownership
+                std::size_t offset;                     // index of next unread character of buffer
+                Token::TokenPosition position;          // used to keep track of position in file
+                Token cursor;                           // used to store last token read
 
                 /**
                  *  @brief read next lexeme
-                 *  @desc attempts to read a lexeme from input, if EOF returns std::nullopt, updates position to end of lexeme and returns start of lexeme
-                 *  @return a pair containing the starting position of the lexeme, and the lexeme as a string if one was there (std::nullopt if EOF)
+                 *  @desc attempts to read a lexeme from input or buffer, if EOF returns std::nullopt, updates position to end of lexeme and returns start of lexeme
+                 *  @return a pair containing the starting position of the lexeme, and the lexeme if one was there (std::nullopt if EOF)
+                **/
+                std::pair<Token::TokenPosition, std::optional<std::string_view>> read_lexeme() noexcept;
+
+                /**
+                 *  @brief read next lexeme from input using getc (streamed mode)
+                 *  @return see read_lexeme
+                **/
+                std::pair<Token::TokenPosition, std::optional<std::string_view>> read_lexeme_from_file() noexcept;
+
+                /**
+                 *  @brief read next lexeme directly from buffer (buffered mode)
+                 *  @return see read_lexeme
                 **/
-                std::pair<Token::TokenPosition, std::optional<std::string>> read_lexeme() noexcept;
+                std::pair<Token::TokenPosition, std::optional<std::string_view>> read_lexeme_from_buffer() noexcept;
 
                 /**
-                 *  @brief convert a Token::TokenPosition, std::string pair into a token
+                 *  @brief convert a Token::TokenPosition, std::string_view pair into a token
                  *  @desc attempts to convert an optional pair into a token, if std::nullopt returns end_of_file token
-                 *  @throws InvalidLexeme if the lexeme passed is an std::string without a valid lexeme representation
+                 *  @throws InvalidLexeme if the lexeme passed is an std::string_view without a valid lexeme representation
                  *  @return Token value that the lexeme represented
                 **/
-                static Token lexeme_to_token(const std::pair<Token::TokenPosition, std::optional<std::string>>&) noexcept(false);
+                static Token lexeme_to_token(const std::pair<Token::TokenPosition, std::optional<std::string_view>>&) noexcept(false);
 
             public:
                 using iterator_category = std::input_iterator_tag;
@@ -95,6 +126,14 @@ class LexStream {
                  *  @throws LexStreamDoubleReadException if input is nullptr
                 **/
                 LexStreamIterator(unique_file_ptr input) noexcept(false);
+
+                /**
+                 *  @brief construct LexStreamIterator, should only be used by LexStream::begin()
+                 *  @desc create iterator for tokens in buffer, calls LexStreamDoubleReadException if buffer is a nullptr
+                 *  @param buffer input file to iterate over, claims ownership (must be std::move'd)
+                 *  @throws LexStreamDoubleReadException if buffer is nullptr
+                **/
+                LexStreamIterator(std::unique_ptr<SourceBuffer> buffer) noexcept(false);
                 
                 /**
                  *  @brief read next token from file
@@ -147,9 +186,10 @@ class LexStream {
          *  @brief create a LexStream from the file located at filepath
          *  @desc creates LexStream from c string filepath, if unable to open file for reading will throw a std::ios_base_failure exception
          *  @param filepath null terminated c-style string with filepath to input file
+         *  @param mode how to read the file, see LexStream::SourceMode
          *  @throws std::ios_base::failure from <ios>
         **/
-        LexStream(const char* const filepath) noexcept(false);
+        LexStream(const char* const filepath, SourceMode mode = SourceMode::buffered) noexcept(false);
         
         /**
          *  @brief create LexStreamIterator to start of LexStream
@@ -172,7 +212,7 @@ class LexStream {
          *  @return bool representing if LexStream instance is still valid (has not yet been consumed)
         **/
         inline bool is_still_valid() const noexcept {
-            return (bool)source;
+            return source || buffer;
         }
 
         /**
@@ -180,7 +220,7 @@ class LexStream {
          *  @return bool representing if LexStream instance is still valid (has not yet been consumed)
         **/
         inline operator bool() const noexcept {
-            return (bool)source;
+            return source || buffer;
         }
 };
 
@@ -0,0 +1,69 @@
+#include "sourcebuffer.hpp"
+
+#include <ios>          // defines std::ios_base::failure reported for files that can not be read
+#include <memory>       // defines std::unique_ptr used to manage std::FILE* ownership
+
+#include <cstdio>       // defines std::fopen and std::fread used when mapping is not available
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define LEXER_SOURCEBUFFER_MMAP
+    #include <fcntl.h>      // defines open
+    #include <sys/mman.h>   // defines mmap and munmap
+    #include <sys/stat.h>   // defines fstat used to get file size
+    #include <unistd.h>     // defines close
+#endif
+
+using std::string_literals::operator ""s;
+using namespace lexer;
+
+SourceBuffer::SourceBuffer(const char* const filepath) noexcept(false) : data(nullptr), size(0), mapped(false) {
+    #ifdef LEXER_SOURCEBUFFER_MMAP
+        const int descriptor = open(filepath, O_RDONLY);
+        if(descriptor < 0){
+            throw std::ios_base::failure("Unable to open file for reading: "s + filepath);
+        }
+
+        struct stat status;
+        if(!fstat(descriptor, &status) && S_ISREG(status.st_mode) && status.st_size > 0){
+            void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(mapping != MAP_FAILED){
+                data = static_cast<const char*>(mapping);
+                size = status.st_size;
+                mapped = true;
+            }
+        }
+
+        close(descriptor);
+
+        if(mapped){
+            return;
+        }
+    #endif
+
+    // mapping not possible, read the whole file instead
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(filepath, "r"), std::fclose);
+    if(!file){
+        throw std::ios_base::failure("Unable to open file for reading: "s + filepath);
+    }
+
+    char block[1 << 16];
+    std::size_t count;
+    while((count = std::fread(block, 1, sizeof(block), file.get())) > 0){
+        fallback.append(block, count);
+    }
+
+    if(std::ferror(file.get())){
+        throw std::ios_base::failure("Unable to read file: "s + filepath);
+    }
+
+    data = fallback.data();
+    size = fallback.size();
+}
+
+SourceBuffer::~SourceBuffer(){
+    #ifdef LEXER_SOURCEBUFFER_MMAP
+        if(mapped){
+            munmap(const_cast<char*>(data), size);
+        }
+    #endif
+}
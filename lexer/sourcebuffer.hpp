@@ -0,0 +1,57 @@
+/**
+ *      @file lexer/sourcebuffer.hpp
+ *      @brief defines SourceBuffer which holds the complete contents of an input file in memory
+ *      @author Anastasia Sokol
+ *
+ *      on POSIX systems the file is memory mapped so that lexing does not copy it at all
+ *      everywhere else (or if mapping fails, for example because the file is empty or a pipe) the file is read into a std::string once
+**/
+
+#ifndef LEXER_SOURCEBUFFER_H
+#define LEXER_SOURCEBUFFER_H
+
+#include <string>       // defines std::string used when the file can not be mapped
+#include <string_view>  // defines std::string_view used to access contents
+
+namespace lexer {
+
+/**
+ *  @brief read only view of an entire input file
+ *
+ *  can not be copied or moved, views returned by view() are valid for the lifetime of the instance
+**/
+class SourceBuffer {
+    private:
+        const char* data;       // start of file contents
+        std::size_t size;       // length of file contents
+        bool mapped;            // true if data is a memory mapping that must be unmapped
+        std::string fallback;   // owns file contents if not mapped
+
+    public:
+        /**
+         *  @brief load the file located at filepath
+         *  @param filepath null terminated c-style string with filepath to input file
+         *  @throws std::ios_base::failure if file can not be opened or read
+        **/
+        SourceBuffer(const char* const filepath) noexcept(false);
+
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator =(const SourceBuffer&) = delete;
+
+        /**
+         *  @brief release mapping if there is one
+        **/
+        ~SourceBuffer();
+
+        /**
+         *  @brief get contents of file
+         *  @return view of entire file
+        **/
+        inline std::string_view view() const noexcept {
+            return std::string_view(data, size);
+        }
+};
+
+} // end of namespace lexer
+
+#endif
@@ -12,46 +12,151 @@
 #include "parser/blockstream.hpp"       // defines parser::BlockStream for creating block streams from token streams
 #include "parser/invalidblock.hpp"      // defines parser::InvalidBlock for reporting generic block parsing errors
 #include "parser/expressionstream.hpp"  // defines parser::ExpressionStream for turning creating an expression stream from block streams
+#include "parser/fusedexpressionstream.hpp" // defines parser::FusedExpressionStream for creating an expression stream directly from token streams
+#include "parser/pipelinedexpressionstream.hpp" // defines parser::PipelinedExpressionStream for parsing on a background thread
+#include "cache/astcache.h"             // defines cache::Reader and cache::Writer for reading and writing precompiled expression caches
 #include "datatype/invalidstate.hpp"    // defines InvalidState exception
 #include "utility/standardlibrary.h"    // defines interface for standard library functions
+#include "utility/output.h"             // defines frstd::StreamOutput which buffers printed text
+#include "utility/memoize.h"            // defines frstd::memo standard library function
+#include "utility/parallel.h"           // defines frstd::pmap and frstd::preduce standard library functions
+#include "utility/threadpool.h"         // defines frstd::ThreadPool::participants set by --threads
+#include "expression/lambdaexpression.h"    // defines LambdaExpression::auto_memoize set by --memo=auto
+#include "expression/functionexpression.h"  // defines FunctionExpression::statistics printed by --cache-stats
 #include "value/functionvalue.h"        // define FunctionValue for wrapping standard library functions
 #include "value/notimplemented.hpp"     // defines NotImplemented exception
+#include "value/valuepool.h"            // defines pool::statistics printed by --pool-stats
+#include "vm/compiler.h"                // defines vm::Compiler for compiling expressions into bytecode
+#include "vm/machine.h"                 // defines vm::Machine for running bytecode
 
 #include <ios>                          // defines std::ios_base::failure for file io errors (also defined in lexer/lexstream.hpp but that is not generally guaranteed)
+#include <iostream>                     // defines std::cout which printed text is written to
 
 #include <cstdio>                       // defines std::fprintf, stderr, EXIT_FAILURE, and EXIT_SUCCESS for reporting program execution state
-#include <cstring>                      // defines std::strcmp
+#include <cstdlib>                      // defines std::strtoul for reading numeric command line options
+#include <cstring>                      // defines std::strcmp and std::strncmp for reading command line options
+#include <thread>                       // defines std::thread::hardware_concurrency used to decide if --pipeline can run in parallel
 
 int main(int argc, char **argv){
     // command interface
-    if(argc != 2){
-        std::puts("The Fragment Interpeter requires exactly one parameters\n\tallowed: -v, --version, -h, --help, or a path to the input file");
-        return EXIT_FAILURE;
+    const char* filepath = nullptr;
+    bool use_vm = false;    // run expressions on vm::Machine instead of walking the expression tree
+    bool use_fused = false; // parse with parser::FusedExpressionStream instead of parser::BlockStream and parser::ExpressionStream
+    bool use_pipeline = false;  // parse on a background thread while expressions run (see parser::PipelinedExpressionStream)
+    bool cache_stats = false;   // print hit rate of call site caches once the program finishes
+    bool pool_stats = false;    // print hit rate of the value pool once the program finishes
+    bool unbuffered = false;    // write printed text to std::cout immediately instead of buffering it
+    bool use_cache = false;     // read expressions from a precompiled cache next to the input file, writing it if missing or stale (see cache/astcache.h)
+
+    for(int i = 1; i < argc; ++i){
+        if(!std::strcmp(argv[i], "-v") || !std::strcmp(argv[i], "--version")){
+            std::puts("Fragment Interpeter v. 1.0");
+            return EXIT_SUCCESS;
+        } else if(!std::strcmp(argv[i], "-h") || !std::strcmp(argv[i], "--help")){
+            std::puts("Fragment Interpeter v. 1.0\n\tallowed parameters: -v, --version, -h, --help, --engine=vm|tree, --parser=fused|staged, --pipeline, --memo=auto|off, --cache-stats, --pool-stats, --threads=n, --unbuffered, --ast-cache, or an input file path\n\tsee README.md for more information");
+            return EXIT_SUCCESS;
+        } else if(!std::strcmp(argv[i], "--engine=vm")){
+            use_vm = true;
+        } else if(!std::strcmp(argv[i], "--engine=tree")){
+            use_vm = false;
+        } else if(!std::strcmp(argv[i], "--parser=fused")){
+            use_fused = true;
+        } else if(!std::strcmp(argv[i], "--parser=staged")){
+            use_fused = false;
+        } else if(!std::strcmp(argv[i], "--pipeline")){
+            use_pipeline = true;
+        } else if(!std::strcmp(argv[i], "--memo=auto")){
+            LambdaExpression::auto_memoize = true;
+        } else if(!std::strcmp(argv[i], "--memo=off")){
+            LambdaExpression::auto_memoize = false;
+        } else if(!std::strcmp(argv[i], "--cache-stats")){
+            cache_stats = true;
+        } else if(!std::strcmp(argv[i], "--pool-stats")){
+            pool_stats = true;
+        } else if(!std::strcmp(argv[i], "--unbuffered")){
+            unbuffered = true;
+        } else if(!std::strcmp(argv[i], "--ast-cache")){
+            use_cache = true;
+        } else if(!std::strncmp(argv[i], "--threads=", 10) && std::strtoul(argv[i] + 10, nullptr, 10)){
+            frstd::ThreadPool::participants = std::strtoul(argv[i] + 10, nullptr, 10);
+        } else if(!std::strncmp(argv[i], "--", 2) || filepath){
+            filepath = nullptr;
+            break;
+        } else {
+            filepath = argv[i];
+        }
     }
 
-    if(!std::strcmp(argv[1], "-v") || !std::strcmp(argv[1], "--version")){
-        std::puts("Fragment Interpeter v. 1.0");
-        return EXIT_SUCCESS;
-    } else if(!std::strcmp(argv[1], "-h") || !std::strcmp(argv[1], "--help")){
-        std::puts("Fragment Interpeter v. 1.0\n\tallowed parameters: -v, --version, -h, --help, or an input file path\n\tsee README.md for more information");
-        return EXIT_SUCCESS;
+    if(!filepath){
+        std::puts("The Fragment Interpeter requires exactly one input file\n\tallowed: -v, --version, -h, --help, --engine=vm|tree, --parser=fused|staged, --pipeline, --memo=auto|off, --cache-stats, --pool-stats, --threads=n, --unbuffered, --ast-cache, and a path to the input file");
+        return EXIT_FAILURE;
     }
-    
-    // interpeter interface
-    const char* filepath = argv[1];
 
     try {
+        // printed text is flushed when this is destroyed, which is before any error is reported
+        frstd::StreamOutput output(std::cout, unbuffered ? 0 : frstd::StreamOutput::default_capacity);
+
         // setup program state
         ProgramState state;
 
-        state.set("print", Value::value_t(new FunctionValue(frstd::print)));
-        state.set("println", Value::value_t(new FunctionValue(frstd::println)));
-        state.set("readline", Value::value_t(new FunctionValue(frstd::readline)));
-        state.set("readnumeric", Value::value_t(new FunctionValue(frstd::readnumeric)));
+        state.set("print", Value::value_t::make<FunctionValue>(frstd::print));
+        state.set("println", Value::value_t::make<FunctionValue>(frstd::println));
+        state.set("readline", Value::value_t::make<FunctionValue>(frstd::readline));
+        state.set("readnumeric", Value::value_t::make<FunctionValue>(frstd::readnumeric));
+        state.set("flush", Value::value_t::make<FunctionValue>(frstd::flush));
+        state.set("memo", Value::value_t::make<FunctionValue>(frstd::memo));
+        state.set("pmap", Value::value_t::make<FunctionValue>(frstd::pmap));
+        state.set("preduce", Value::value_t::make<FunctionValue>(frstd::preduce));
+        
+        vm::Machine machine(state);
+
+        // workers of pmap and preduce are layered over this state, closures they return run here once they are done
+        ProgramState::current = &state;
+        vm::Machine::current = &machine;
+        
+        const auto run = [&](Expression::expression_t expression){
+            Expression::optimize(expression);
+
+            if(use_vm){
+                machine.run(vm::Compiler::compile(*expression));
+            } else {
+                (*expression)(state);
+            }
+        };
         
-        // build and run program
-        for(const auto& expression : parser::ExpressionStream(parser::BlockStream(lexer::LexStream(filepath)))){
-            (*expression)(state);
+        // expressions are only written to the cache once every one of them was parsed and ran
+        cache::Writer writer;
+        const auto execute = [&](auto &&expressions){
+            for(const auto& expression : expressions){
+                if(use_cache){
+                    writer.add(*expression);
+                }
+                run(expression);
+            }
+
+            if(use_cache){
+                writer.save(filepath);
+            }
+        };
+
+        const auto open_fused = [filepath](){ return parser::FusedExpressionStream(lexer::LexStream(filepath)); };
+        const auto open_staged = [filepath](){ return parser::ExpressionStream(parser::BlockStream(lexer::LexStream(filepath))); };
+        
+        // build and run program (parsing in the background only pays off if the parser gets a hardware thread of its own)
+        if(const auto cached = use_cache ? cache::Reader::open(filepath) : nullptr){
+            for(const auto& expression : *cached){
+                run(expression);
+            }
+        } else if(use_pipeline && std::thread::hardware_concurrency() > 1){
+            if(use_fused){
+                execute(parser::PipelinedExpressionStream(open_fused));
+            } else {
+                execute(parser::PipelinedExpressionStream(open_staged));
+            }
+        } else if(use_fused){
+            execute(open_fused());
+        } else {
+            execute(open_staged());
         }
     } catch(std::ios_base::failure &error){
         std::fprintf(stderr, "\033[31mFile Error\033[39m\n\t%s\n", error.what());
@@ -70,5 +175,20 @@ int main(int argc, char **argv){
         std::fprintf(stderr, "\033[31mOperation Not Implemented\033[39m\n\terror: %s\n\tposition: file %s\n", error.what(), filepath);
     }
 
+    if(cache_stats){
+        const auto &statistics = FunctionExpression::statistics;
+        const unsigned long long total = statistics.hits + statistics.misses;
+        std::fprintf(stderr, "call site cache: %llu hits, %llu misses (%.1f%% hit rate)\n", (unsigned long long)statistics.hits, (unsigned long long)statistics.misses, total ? 100.0 * statistics.hits / total : 0.0);
+    }
+
+    if(pool_stats){
+        for(std::size_t index = 0; index < pool::classes; ++index){
+            const pool::Statistics statistics = pool::statistics(index);
+            if(statistics.allocations){
+                std::fprintf(stderr, "value pool: %zu byte blocks, %llu allocations, %llu chunks, %llu refills, %llu spills (%.1f%% hit rate)\n", (index + 1) * pool::granularity, (unsigned long long)statistics.allocations, (unsigned long long)statistics.chunks, (unsigned long long)statistics.refills, (unsigned long long)statistics.spills, 100.0 * statistics.hits / statistics.allocations);
+            }
+        }
+    }
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include "../utility/iteratetypeguard.h"    // defines only_if_iterator_type used to restrict container_t typename 
 #include "invalidblock.hpp"                 // defines exception parser::InvalidBlock for reporting token streams that do not represent valid blocks
 
+#include <cstdint>                           // defines std::uint32_t used to refer to blocks inside of the Block arena
+
 namespace parser {
 
 /**
@@ -61,43 +63,51 @@ class BlockStream {
                 
                 /**
                  *  @brief attempts to read a complete block from stream
-                 *  @desc uses next() to recursively read a blocks until the top level block is formed, or an exception state is reached
+                 *  @desc uses next() and read_block_contents to read tokens until the top level block is formed, or an exception state is reached
                  *  @return a block object representing structure or with end_of_file token if end of stream reached without starting a block
                 **/
-                Block read_block_from_stream(bool is_starting_block = true) noexcept(false) {
+                Block read_block_from_stream() noexcept(false) {
                     // read first token of block
                     Token token = next();
                     
-                    // handle special case of starting block
-                    if(is_starting_block){
-                        // end of file is ok for starting block, return end of stream value
-                        if(token.type == Token::TokenType::end_of_file){
-                            return Block(token.position).append(token);
-                        }
-
-                        // if not end of file, must begin with openning delimiter
-                        if(!(token.type == Token::TokenType::delimiter && token.value == "(")){
-                            throw InvalidBlock("Top level expression blocks must begin with an opening delimiter '('", token.position);
-                        }
+                    // end of file is ok for starting block, return end of stream value
+                    if(token.type == Token::TokenType::end_of_file){
+                        return Block(token.position).append(token);
+                    }
 
-                        // advance token so that the rest of the function can act like a non-top level block expression
-                        token = next();
+                    // if not end of file, must begin with openning delimiter
+                    if(!(token.type == Token::TokenType::delimiter && token.value == "(")){
+                        throw InvalidBlock("Top level expression blocks must begin with an opening delimiter '('", token.position);
                     }
 
+                    // advance token so that the rest of the block can be read like a nested block
+                    token = next();
+
                     Block block(token.position);
+                    read_block_contents(block, 0, token);
+                    return block;
+                }
 
+                /**
+                 *  @brief recursively read the contents of a block into the arena, up to and including its closing delimiter
+                 *  @param block arena being built
+                 *  @param parent index of the block in the arena that is being read
+                 *  @param token first token inside of the block
+                **/
+                void read_block_contents(Block &block, const std::uint32_t parent, Token token) noexcept(false) {
                     while(!(token.value == ")" && token.type == Token::TokenType::delimiter)){
                         if(token.type == Token::TokenType::end_of_file){
                             throw InvalidBlock("Unexpected end of file: unclosed expression block scope", token.position);
                         } else if(token.type == Token::TokenType::delimiter && token.value == "("){
-                            block.append(read_block_from_stream(false));
+                            const Token first = next();
+                            const std::uint32_t child = block.open(first.position, parent);
+                            read_block_contents(block, child, first);
+                            block.close(child);
                         } else {
-                            block.append(token);
+                            block.append(token, parent);
                         }
                         token = next();
                     }
-
-                    return block;
                 }
 
             public:
@@ -151,7 +161,8 @@ class BlockStream {
                  *  @return bool signifing if the end of the stream has been reached 
                 **/
                 inline bool operator ==(const Block& block) const {
-                    return block.size() == 1 && block.size() == cursor.size() && std::holds_alternative<Token>(block.view.front()) && std::holds_alternative<Token>(cursor.view.front()) && std::get<Token>(block.view.front()).type == Token::TokenType::end_of_file && std::get<Token>(cursor.view.front()).type == Token::TokenType::end_of_file;
+                    const auto is_end_of_file = [](const Block &value) -> bool { return value.size() == 1 && value.root().front().is_token() && value.root().front().token().type == Token::TokenType::end_of_file; };
+                    return is_end_of_file(block) && is_end_of_file(cursor);
                 }
 
                 /**
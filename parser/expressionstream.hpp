@@ -16,14 +16,13 @@
 #include "../expression/defineexpression.h"         // defines DefineExpression
 #include "../expression/lambdaexpression.h"         // defines LambdaExpression
 #include "../expression/conditionalexpression.h"    // defines ConditionalExpression
-#include "../expression/operatorexpression.h"       // defines OperatorExpression and OperatorExpression::OperatorType
 #include "../expression/functionexpression.h"       // defines FunctionExpression
-#include "../value/numericvalue.h"                  // defines NumericValue
-#include "../value/booleanvalue.h"                  // defines BooleanValue
-#include "../value/stringvalue.h"                   // defines StringValue
+#include "grammar.hpp"                              // defines atomic_expression_from_token and operator_expression shared with FusedExpressionStream
 
 
 #include <algorithm>                            // defines std::all_of for pattern matching
+#include <string>                               // defines std::string used to copy token text into expressions
+#include <string_view>                          // defines std::string_view used to inspect token text
 
 namespace parser {
 
@@ -48,33 +47,13 @@ class ExpressionStream {
 
                 Expression::expression_t cursor;        // stores current expression
 
-                std::variant<Value::value_t, std::string> value_from_token(const Token &token){
-                    using tt = Token::TokenType;
-                    using vt = Value::value_t;
-
-                    if(token.type == tt::reference){
-                        return token.value;
-                    }
-
-                    if(token.type == tt::numeric){
-                        return vt(new NumericValue(std::stod(token.value)));
-                    } else if(token.type == tt::boolean){
-                        return vt(new BooleanValue(token.value == "true"));
-                    } else if(token.type == tt::stringliteral){
-                        return vt(new StringValue(token.value));
-                    }
-
-                    throw InvalidExpression(token.position, "Expected a valued token but got a token of type [" + to_string(token.type) + "]");
-                }
-
-                Expression::expression_t atomic_expression_from_token(const Token &token){
-                    using exp_t = Expression::expression_t;
-                    std::variant<Value::value_t, std::string> value = value_from_token(token);
-                    if(std::holds_alternative<Value::value_t>(value)){
-                        return exp_t(new AtomicExpression(token.position, std::get<Value::value_t>(value)));
-                    } else {
-                        return exp_t(new AtomicExpression(token.position, std::get<std::string>(value)));
-                    }
+                /**
+                 *  @brief read a single member of a block as an expression
+                 *  @desc tokens become atomic expressions, nested blocks are read with read_block_into_expression
+                 *  @return Expression::expression_t representing element
+                **/
+                Expression::expression_t read_element_into_expression(const Block::Element element){
+                    return element.is_token() ? atomic_expression_from_token(element.token()) : read_block_into_expression(element);
                 }
 
                 /**
@@ -82,7 +61,7 @@ class ExpressionStream {
                  *  @desc recursively reads expressions into the top level expression, then returns
                  *  @return Expression::expression_t representing next expression in input stream 
                 **/
-                Expression::expression_t read_block_into_expression(const Block &block){
+                Expression::expression_t read_block_into_expression(const Block::Element block){
                     /**
                      *  this code implements the grammar
                      *  I apologize for how messy it is
@@ -94,161 +73,114 @@ class ExpressionStream {
 
                     if(block.size() == 1){
                         // must be a self expression
-
-                        bool token = std::holds_alternative<Token>(block.view.front()); // check if token or block
-
-                        if(token){
-                            // token inside block
-                            return exp_t(new SelfExpression(block.position, atomic_expression_from_token(std::get<Token>(block.view.front()))));
-                        } else {
-                            // block inside block
-                            return exp_t(new SelfExpression(block.position, read_block_into_expression(std::get<Block>(block.view.front()))));
-                        }
+                        return exp_t(new SelfExpression(block.position(), read_element_into_expression(block.front())));
                     }
 
-                    if(std::holds_alternative<Token>(block.view.front()) && std::get<Token>(block.view.front()).type == Token::TokenType::keyword){
+                    if(block.size() && block.front().is_token() && block.front().token().type == Token::TokenType::keyword){
                         // must be a keyword expression (either define, lambda, or conditional)
                         
-                        std::string keyword = std::get<Token>(block.view.front()).value;
+                        const std::string_view keyword = block.front().token().value;
 
                         if(keyword == "define"){
                             if(block.size() != 3){
-                                throw InvalidExpression(block.position, "The 'define' expression expects 2 parameters; a reference and a sub expression. Got " + std::to_string(block.size() - 1));
+                                throw InvalidExpression(block.position(), "The 'define' expression expects 2 parameters; a reference and a sub expression. Got " + std::to_string(block.size() - 1));
                             }
 
-                            auto members = block.view.begin();
+                            auto members = block.begin();
                             
-                            std::variant<Token, Block> name = *++members;
-                            std::variant<Token, Block> value = *++members;
+                            const Block::Element name = *++members;
+                            const Block::Element value = *++members;
 
-                            if(!std::holds_alternative<Token>(name) || std::get<Token>(name).type != Token::TokenType::reference){
-                                throw InvalidExpression(block.position, "Expected the first parameter to 'define' expression to be a reference");
+                            if(!name.is_token() || name.token().type != Token::TokenType::reference){
+                                throw InvalidExpression(block.position(), "Expected the first parameter to 'define' expression to be a reference");
                             }
 
-                            return exp_t(new DefineExpression(block.position, std::get<Token>(name).value, std::holds_alternative<Token>(value) ?
-                                    atomic_expression_from_token(std::get<Token>(value))
-                                :   read_block_into_expression(std::get<Block>(value))
-                            ));
+                            return exp_t(new DefineExpression(block.position(), ProgramState::resolve(name.token().value), read_element_into_expression(value)));
                         } else if(keyword == "lambda"){
                             if(block.size() != 3){
-                                throw InvalidExpression(block.position, "The 'lambda' expression expects 2 parameters; a set of references and a body expression. Got " + std::to_string(block.size() - 1));
+                                throw InvalidExpression(block.position(), "The 'lambda' expression expects 2 parameters; a set of references and a body expression. Got " + std::to_string(block.size() - 1));
                             }
 
-                            auto members = block.view.begin();
+                            auto members = block.begin();
                             
-                            std::variant<Token, Block> parameters = *++members;
-                            std::variant<Token, Block> body = *++members;
+                            const Block::Element parameters = *++members;
+                            const Block::Element body = *++members;
 
-                            if(!std::holds_alternative<Block>(parameters)){
-                                throw InvalidExpression(block.position, "lambda expressions require that the first parameter is a set of references");
+                            if(!parameters.is_block()){
+                                throw InvalidExpression(block.position(), "lambda expressions require that the first parameter is a set of references");
                             }
 
-                            if(!std::all_of(std::get<Block>(parameters).begin(), std::get<Block>(parameters).end(), [](std::variant<Token, Block> value) -> bool { return std::holds_alternative<Token>(value) && std::get<Token>(value).type == Token::TokenType::reference; })){
-                                throw InvalidExpression(block.position, "lambda expressions require that the first parameter is a set of references");
+                            if(!std::all_of(parameters.begin(), parameters.end(), [](const Block::Element value) -> bool { return value.is_token() && value.token().type == Token::TokenType::reference; })){
+                                throw InvalidExpression(block.position(), "lambda expressions require that the first parameter is a set of references");
                             }
 
-                            Expression::expression_t body_expression = std::holds_alternative<Token>(body) ? atomic_expression_from_token(std::get<Token>(body)) : read_block_into_expression(std::get<Block>(body));
+                            Expression::expression_t body_expression = read_element_into_expression(body);
 
-                            std::list<std::string> named_parameters;
-                            for(const auto &param : std::get<Block>(parameters)){
-                                named_parameters.push_back(std::get<Token>(param).value);
+                            std::vector<ProgramState::slot_t> parameter_slots;
+                            for(const Block::Element param : parameters){
+                                parameter_slots.push_back(ProgramState::resolve(param.token().value));
                             }
 
-                            return exp_t(new LambdaExpression(block.position, std::move(named_parameters), body_expression));
+                            return exp_t(new LambdaExpression(block.position(), std::move(parameter_slots), body_expression));
                         } else if(keyword == "if"){
                             if(block.size() != 4){
-                                throw InvalidExpression(block.position, "The 'if' conditional expression expects 3 parameters; a condition, a path for true, and a path for false. Got " + std::to_string(block.size() - 1));
+                                throw InvalidExpression(block.position(), "The 'if' conditional expression expects 3 parameters; a condition, a path for true, and a path for false. Got " + std::to_string(block.size() - 1));
                             }
 
-                            auto members = block.view.begin();
+                            auto members = block.begin();
                             
-                            std::variant<Token, Block> condition = *++members;
-                            std::variant<Token, Block> truthy = *++members;
-                            std::variant<Token, Block> falsy = *++members;
+                            const Block::Element condition = *++members;
+                            const Block::Element truthy = *++members;
+                            const Block::Element falsy = *++members;
 
-                            auto cpath = std::holds_alternative<Token>(condition) ? atomic_expression_from_token(std::get<Token>(condition)) : read_block_into_expression(std::get<Block>(condition));
-                            auto tpath = std::holds_alternative<Token>(truthy) ? atomic_expression_from_token(std::get<Token>(truthy)) : read_block_into_expression(std::get<Block>(truthy));
-                            auto fpath = std::holds_alternative<Token>(falsy) ? atomic_expression_from_token(std::get<Token>(falsy)) : read_block_into_expression(std::get<Block>(falsy));
+                            auto cpath = read_element_into_expression(condition);
+                            auto tpath = read_element_into_expression(truthy);
+                            auto fpath = read_element_into_expression(falsy);
 
-                            return exp_t(new ConditionalExpression(block.position, cpath, tpath, fpath));
+                            return exp_t(new ConditionalExpression(block.position(), cpath, tpath, fpath));
                         } else {
-                            throw InvalidExpression(block.position, "Expected keyword from token but got value [" + keyword + "] (likely internal parsing error)");
+                            throw InvalidExpression(block.position(), "Expected keyword from token but got value [" + std::string(keyword) + "] (likely internal parsing error)");
                         }
                     }
 
-                    if(std::holds_alternative<Token>(block.view.front()) && std::get<Token>(block.view.front()).type == Token::TokenType::operation){
+                    if(block.size() && block.front().is_token() && block.front().token().type == Token::TokenType::operation){
                         // must be an operation expression
                         // note that operator expression constructor does some error handling for us in regards to number of arguments
                         
                         std::list<Expression::expression_t> parameters;
 
-                        for(auto it = ++block.view.begin(); it != block.view.end(); ++it){
-                            parameters.push_back(std::holds_alternative<Token>(*it) ? atomic_expression_from_token(std::get<Token>(*it)) : read_block_into_expression(std::get<Block>(*it)));
+                        for(auto it = ++block.begin(); it != block.end(); ++it){
+                            parameters.push_back(read_element_into_expression(*it));
                         }
 
-                        using optype = OperatorExpression::OperatorType;
-
-                        std::string operation = std::get<Token>(block.view.front()).value;
-
-                        switch(operation[0]){
-                            case '+':
-                                return exp_t(new OperatorExpression(block.position, optype::operator_add, std::move(parameters)));
-                            
-                            case '-':
-                                return exp_t(new OperatorExpression(block.position, optype::operator_subtract, std::move(parameters)));
-                            
-                            case '*':
-                                return exp_t(new OperatorExpression(block.position, optype::operator_multiply, std::move(parameters)));
-                            
-                            case '/':
-                                return exp_t(new OperatorExpression(block.position, optype::operator_divide, std::move(parameters)));
-                            
-                            case '<':
-                                return exp_t(new OperatorExpression(block.position, operation == "<=" ? optype::operator_less_or_equal : optype::operator_less, std::move(parameters)));
-                            
-                            case '>':
-                                return exp_t(new OperatorExpression(block.position, operation == ">=" ? optype::operator_greater_or_equal : optype::operator_greater, std::move(parameters)));
-                            
-                            case '&':
-                                if(operation != "&&"){ throw InvalidExpression(block.position, "Not a valid operator [" + operation + "] (parse error)"); }
-                                return exp_t(new OperatorExpression(block.position, optype::operator_and, std::move(parameters)));
-                            
-                            case '|':
-                                if(operation != "||"){ throw InvalidExpression(block.position, "Not a valid operator [" + operation + "] (parse error)"); }
-                                return exp_t(new OperatorExpression(block.position, optype::operator_or, std::move(parameters)));
-                            
-                            case '!':
-                                return exp_t(new OperatorExpression(block.position, optype::operator_not, std::move(parameters)));
-                        };
-
-                        throw InvalidExpression(block.position, "Invalid operator (parse error) [" + operation + "]");
+                        return operator_expression(block.position(), block.front().token().value, std::move(parameters));
                     }
 
-                    if(std::holds_alternative<Token>(block.view.front()) && std::get<Token>(block.view.front()).type == Token::TokenType::comment){
+                    if(block.size() && block.front().is_token() && block.front().token().type == Token::TokenType::comment){
                         // turn comments into no ops
-                        return exp_t(new AtomicExpression(block.position, Value::value_t(new BooleanValue(false))));
+                        return exp_t(new AtomicExpression(block.position(), Value::value_t(false)));
                     }
 
                     {
                         // the only pattern left is a function expression
 
-                        if(block.view.size() < 2){
-                            throw InvalidExpression(block.position, "Function expressions require at least one arguments");
+                        if(block.size() < 2){
+                            throw InvalidExpression(block.position(), "Function expressions require at least one arguments");
                         }
 
                         std::list<Expression::expression_t> parameters;
 
-                        for(auto it = ++block.view.begin(); it != block.view.end(); ++it){
-                            parameters.push_back(std::holds_alternative<Token>(*it) ? atomic_expression_from_token(std::get<Token>(*it)) : read_block_into_expression(std::get<Block>(*it)));
+                        for(auto it = ++block.begin(); it != block.end(); ++it){
+                            parameters.push_back(read_element_into_expression(*it));
                         }
 
-                        Expression::expression_t function = std::holds_alternative<Token>(block.view.front()) ? atomic_expression_from_token(std::get<Token>(block.view.front())) : read_block_into_expression(std::get<Block>(block.view.front()));
+                        Expression::expression_t function = read_element_into_expression(block.front());
                     
-                        return exp_t(new FunctionExpression(block.position, function, std::move(parameters)));
+                        return exp_t(new FunctionExpression(block.position(), function, std::move(parameters)));
                     }
                     
                     // unreachable
-                    throw InvalidExpression(block.position, "Failed to match expression pattern (parse error)");
+                    throw InvalidExpression(block.position(), "Failed to match expression pattern (parse error)");
                 }
 
             public:
@@ -275,7 +207,7 @@ class ExpressionStream {
                 **/
                 ExpressionStreamIterator& operator ++() noexcept(false) {
                     if(stream != end){
-                        cursor = read_block_into_expression(*stream);
+                        cursor = read_block_into_expression(stream->root());
                         ++stream;
                     } else {
                         cursor = Expression::expression_t(nullptr);
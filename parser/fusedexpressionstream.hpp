@@ -0,0 +1,430 @@
+/**
+ *      @file parser/fusedexpressionstream.hpp
+ *      @brief defines template class FusedExpressionStream in namespace parser for turning a stream of tokens directly into a stream of expressions
+ *      @author Anastasia Sokol
+ *
+ *      equivalent to ExpressionStream(BlockStream(tokens)) but builds expressions while reading tokens, without creating any Block
+ *      errors are reported exactly as the two stage pipeline reports them
+ *          the whole of a top level block is read (reporting any InvalidLexeme or InvalidBlock) before any InvalidExpression from inside it
+ *          expression errors in nested blocks are held until the enclosing block would have read that member
+ *          the next top level block is read before the current expression is returned
+**/
+
+#ifndef PARSER_FUSEDEXPRESSIONSTREAM_H
+#define PARSER_FUSEDEXPRESSIONSTREAM_H
+
+#include "../datatype/token.hpp"                    // defines Token which is the input to this class
+#include "../utility/iteratetypeguard.h"            // defines only_if_iterater_type used to restrict generic containter_t template type
+#include "../expression/invalidexpression.hpp"      // defines InvalidExpression exception
+#include "../expression/expression.hpp"             // defines Expression which is the base return type
+#include "../expression/selfexpression.h"           // defines SelfExpression
+#include "../expression/atomicexpression.h"         // defines AtomicExpression
+#include "../expression/defineexpression.h"         // defines DefineExpression
+#include "../expression/lambdaexpression.h"         // defines LambdaExpression
+#include "../expression/conditionalexpression.h"    // defines ConditionalExpression
+#include "../expression/functionexpression.h"       // defines FunctionExpression
+#include "invalidblock.hpp"                         // defines exception parser::InvalidBlock for reporting token streams that do not represent valid blocks
+#include "grammar.hpp"                              // defines atomic_expression_from_token and operator_expression shared with ExpressionStream
+
+#include <exception>                                // defines std::exception_ptr used to hold errors until they would have been reported
+#include <list>                                     // defines std::list used to pass arguments to expressions
+#include <optional>                                 // defines std::optional used for lambda parameter lists that may be invalid
+#include <string>                                   // defines std::string used to report invalid keywords
+#include <vector>                                   // defines std::vector used as a stack of block members
+
+namespace parser {
+
+/**
+ *  @brief transforms a stream of tokens into a stream of expressions in a single pass
+**/
+template <typename container_t, only_if_iterater_type(container_t, const Token)>
+class FusedExpressionStream {
+    private:
+        // generic types of container iterator
+        typedef decltype(std::declval<container_t>().begin()) stream_iterator_begin_type;
+        typedef decltype(std::declval<container_t>().end()) stream_iterator_end_type;
+
+        stream_iterator_begin_type start_of_stream;     // stores iterator to start of container
+        stream_iterator_end_type end_of_stream;         // stores end of iterator
+
+    public:
+        struct FusedExpressionStreamIterator {
+            private:
+                /**
+                 *  @brief a direct member of a block that is being read
+                **/
+                struct Member {
+                    Token token;                                        // token, or first token inside of a nested block
+                    bool block;                                         // true if member is a nested block
+                    Expression::expression_t expression;                // nested block as an expression (if read as one without error)
+                    std::exception_ptr error;                           // error reading nested block as an expression, reported only if member is used
+                    std::optional<std::vector<ProgramState::slot_t>> parameters;    // nested block read as lambda parameter slots (std::nullopt if not all references)
+                };
+
+                stream_iterator_begin_type stream;              // current position in stream
+                const stream_iterator_end_type end_of_stream;   // end of stream, used to determine end of stream
+
+                std::vector<Member> members;                    // members of every block currently being read, innermost last
+                
+                Expression::expression_t cursor;                // stores current expression
+                Expression::expression_t lookahead;             // next expression, already read
+                std::exception_ptr lookahead_error;             // error building next expression, reported when it becomes current
+
+                /**
+                 *  @brief read a token from stream, does not advance past end of file
+                **/
+                const Token next(){
+                    Token value = *stream;
+                    
+                    if(stream != end_of_stream){
+                        ++stream;
+                    }
+
+                    return value;
+                }
+
+                static bool is_open(const Token &token) noexcept {
+                    return token.type == Token::TokenType::delimiter && token.value == "(";
+                }
+
+                static bool is_close(const Token &token) noexcept {
+                    return token.type == Token::TokenType::delimiter && token.value == ")";
+                }
+
+                /**
+                 *  @brief read the next top level block as an expression
+                 *  @throws InvalidBlock as soon as the structure is invalid, InvalidExpression only once the whole block is read
+                 *  @return next expression, or nullptr at end of file
+                **/
+                Expression::expression_t read_top_level() noexcept(false) {
+                    members.clear();
+
+                    Token token = next();
+
+                    // end of file is ok between top level blocks
+                    if(token.type == Token::TokenType::end_of_file){
+                        return Expression::expression_t(nullptr);
+                    }
+
+                    if(!is_open(token)){
+                        throw InvalidBlock("Top level expression blocks must begin with an opening delimiter '('", token.position);
+                    }
+
+                    return read_block(next());
+                }
+
+                /**
+                 *  @brief skip over the rest of a nested block, checking only its structure
+                 *  @param token first token inside of the block
+                **/
+                void skip_block(Token token) noexcept(false) {
+                    while(!is_close(token)){
+                        if(token.type == Token::TokenType::end_of_file){
+                            throw InvalidBlock("Unexpected end of file: unclosed expression block scope", token.position);
+                        } else if(is_open(token)){
+                            skip_block(next());
+                        }
+                        token = next();
+                    }
+                }
+
+                /**
+                 *  @brief read the rest of a nested block as a lambda parameter list
+                 *  @param token first token inside of the block
+                 *  @return slots of parameters, or std::nullopt if any member is not a reference
+                **/
+                std::optional<std::vector<ProgramState::slot_t>> read_parameters(Token token) noexcept(false) {
+                    std::vector<ProgramState::slot_t> slots;
+                    bool valid = true;
+
+                    while(!is_close(token)){
+                        if(token.type == Token::TokenType::end_of_file){
+                            throw InvalidBlock("Unexpected end of file: unclosed expression block scope", token.position);
+                        } else if(is_open(token)){
+                            valid = false;
+                            skip_block(next());
+                        } else if(token.type == Token::TokenType::reference){
+                            slots.push_back(ProgramState::resolve(token.value));
+                        } else {
+                            valid = false;
+                        }
+                        token = next();
+                    }
+
+                    return valid ? std::optional<std::vector<ProgramState::slot_t>>(std::move(slots)) : std::nullopt;
+                }
+
+                /**
+                 *  @brief read the rest of a block and build the expression it represents
+                 *  @param token first token inside of the block (its position is the position of the block)
+                 *  @return expression represented by block
+                **/
+                Expression::expression_t read_block(Token token) noexcept(false) {
+                    const std::size_t base = members.size();
+                    const Token::TokenPosition position = token.position;
+
+                    while(!is_close(token)){
+                        if(token.type == Token::TokenType::end_of_file){
+                            throw InvalidBlock("Unexpected end of file: unclosed expression block scope", token.position);
+                        }
+
+                        // the first member decides how nested blocks are read
+                        const std::size_t index = members.size() - base;
+                        const bool head_is_token = index > 0 && !members[base].block;
+                        const Token::TokenType head = head_is_token ? members[base].token.type : Token::TokenType::null;
+
+                        if(is_open(token)){
+                            Member member{next(), true, nullptr, nullptr, std::nullopt};
+
+                            if(index == 1 && head == Token::TokenType::keyword && members[base].token.value == "lambda"){
+                                member.parameters = read_parameters(member.token);
+                            } else if(head == Token::TokenType::comment){
+                                skip_block(member.token);
+                            } else {
+                                try {
+                                    member.expression = read_block(member.token);
+                                } catch(const InvalidExpression&) {
+                                    member.error = std::current_exception();
+                                }
+                            }
+
+                            members.push_back(std::move(member));
+                        } else {
+                            members.push_back(Member{token, false, nullptr, nullptr, std::nullopt});
+                        }
+
+                        token = next();
+                    }
+
+                    try {
+                        Expression::expression_t expression = build_expression(position, base);
+                        members.resize(base);
+                        return expression;
+                    } catch(...) {
+                        members.resize(base);
+                        throw;
+                    }
+                }
+
+                /**
+                 *  @brief use a member as an expression
+                 *  @throws InvalidExpression held from reading the member
+                **/
+                Expression::expression_t read_member(const Member &member){
+                    if(!member.block){
+                        return atomic_expression_from_token(member.token);
+                    }
+
+                    if(member.error){
+                        std::rethrow_exception(member.error);
+                    }
+
+                    return member.expression;
+                }
+
+                /**
+                 *  @brief build an expression from the members of a completely read block
+                 *  @desc checks happen in the same order as in ExpressionStream::read_block_into_expression
+                 *  @param position of block
+                 *  @param base index of first member of block
+                **/
+                Expression::expression_t build_expression(const Token::TokenPosition &position, const std::size_t base){
+                    using exp_t = Expression::expression_t;
+
+                    const std::size_t size = members.size() - base;
+                    const auto member = [this, base](std::size_t index) -> const Member& { return members[base + index]; };
+
+                    if(size == 1){
+                        // must be a self expression
+                        return exp_t(new SelfExpression(position, read_member(member(0))));
+                    }
+
+                    const bool head_is_token = size && !member(0).block;
+
+                    if(head_is_token && member(0).token.type == Token::TokenType::keyword){
+                        // must be a keyword expression (either define, lambda, or conditional)
+
+                        const std::string_view keyword = member(0).token.value;
+
+                        if(keyword == "define"){
+                            if(size != 3){
+                                throw InvalidExpression(position, "The 'define' expression expects 2 parameters; a reference and a sub expression. Got " + std::to_string(size - 1));
+                            }
+
+                            if(member(1).block || member(1).token.type != Token::TokenType::reference){
+                                throw InvalidExpression(position, "Expected the first parameter to 'define' expression to be a reference");
+                            }
+
+                            return exp_t(new DefineExpression(position, ProgramState::resolve(member(1).token.value), read_member(member(2))));
+                        } else if(keyword == "lambda"){
+                            if(size != 3){
+                                throw InvalidExpression(position, "The 'lambda' expression expects 2 parameters; a set of references and a body expression. Got " + std::to_string(size - 1));
+                            }
+
+                            if(!member(1).block || !member(1).parameters.has_value()){
+                                throw InvalidExpression(position, "lambda expressions require that the first parameter is a set of references");
+                            }
+
+                            Expression::expression_t body_expression = read_member(member(2));
+
+                            return exp_t(new LambdaExpression(position, *member(1).parameters, body_expression));
+                        } else if(keyword == "if"){
+                            if(size != 4){
+                                throw InvalidExpression(position, "The 'if' conditional expression expects 3 parameters; a condition, a path for true, and a path for false. Got " + std::to_string(size - 1));
+                            }
+
+                            auto cpath = read_member(member(1));
+                            auto tpath = read_member(member(2));
+                            auto fpath = read_member(member(3));
+
+                            return exp_t(new ConditionalExpression(position, cpath, tpath, fpath));
+                        } else {
+                            throw InvalidExpression(position, "Expected keyword from token but got value [" + std::string(keyword) + "] (likely internal parsing error)");
+                        }
+                    }
+
+                    if(head_is_token && member(0).token.type == Token::TokenType::operation){
+                        // must be an operation expression
+                        std::list<Expression::expression_t> parameters;
+
+                        for(std::size_t i = 1; i < size; ++i){
+                            parameters.push_back(read_member(member(i)));
+                        }
+
+                        return operator_expression(position, member(0).token.value, std::move(parameters));
+                    }
+
+                    if(head_is_token && member(0).token.type == Token::TokenType::comment){
+                        // turn comments into no ops
+                        return exp_t(new AtomicExpression(position, Value::value_t(false)));
+                    }
+
+                    // the only pattern left is a function expression
+
+                    if(size < 2){
+                        throw InvalidExpression(position, "Function expressions require at least one arguments");
+                    }
+
+                    std::list<Expression::expression_t> parameters;
+
+                    for(std::size_t i = 1; i < size; ++i){
+                        parameters.push_back(read_member(member(i)));
+                    }
+
+                    Expression::expression_t function = read_member(member(0));
+
+                    return exp_t(new FunctionExpression(position, function, std::move(parameters)));
+                }
+
+                /**
+                 *  @brief read the next top level block into lookahead, holding on to any expression error
+                **/
+                void read_lookahead() noexcept(false) {
+                    lookahead = nullptr;
+                    lookahead_error = nullptr;
+
+                    try {
+                        lookahead = read_top_level();
+                    } catch(const InvalidExpression&) {
+                        lookahead_error = std::current_exception();
+                    }
+                }
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type   = void;
+                using value_type        = Expression::expression_t;
+                using pointer           = value_type*;
+                using reference         = value_type&;
+
+                /**
+                 *  @brief create iterator from streams
+                 *  @desc moves iterators and loads first expression
+                 *  @param begin - ing of stream
+                 *  @param end of stream
+                */
+                FusedExpressionStreamIterator(stream_iterator_begin_type begin, stream_iterator_end_type end) : stream(std::move(begin)), end_of_stream(std::move(end)) {
+                    read_lookahead();
+                    ++*this;
+                }
+
+                /**
+                 *  @brief increment cursor to next expression
+                 *  @desc reports any error in the next expression, then reads the top level block after it
+                 *  @return reference to stream 
+                **/
+                FusedExpressionStreamIterator& operator ++() noexcept(false) {
+                    if(lookahead_error){
+                        std::rethrow_exception(lookahead_error);
+                    }
+
+                    cursor = lookahead;
+
+                    if(cursor){
+                        read_lookahead();
+                    }
+
+                    return *this;
+                }
+
+                /**
+                 *  @brief access expression cursor
+                 *  @desc pointer is invalidated after a call to operator ++()
+                 *  @return a constant pointer to the expression cursor 
+                **/
+                inline const Expression::expression_t* operator ->() const noexcept {
+                    return &cursor;
+                }
+
+                /**
+                 *  @brief access expression cursor
+                 *  @desc reference is invalidated after a call to operator ++()
+                 *  @return a constant reference to the expression cursor 
+                **/
+                inline const Expression::expression_t& operator *() const noexcept {
+                    return cursor;
+                }
+
+                /**
+                 *  @brief checks if the Expression::expression_t's have the some truthiness
+                 *  @return boolean (meant for testing end of stream) 
+                **/
+                inline bool operator ==(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor == (bool)other;
+                }
+
+                /**
+                 *  @brief checks if the Expression::expression_t's have different truthiness
+                 *  @return boolean (meant for testing end of stream) 
+                **/
+                inline bool operator !=(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor != (bool)other;
+                }
+        };
+
+        /**
+         *  @brief construct FusedExpressionStream with given token container
+         *  @param container object that will have .begin() and .end() called on it
+        **/
+        inline FusedExpressionStream(container_t container) : start_of_stream(container.begin()), end_of_stream(container.end()) {}
+
+        /**
+         *  @brief get iterator to start of expression stream, only ensured to be valid once
+         *  @return iterator to start of expression stream
+        **/
+        FusedExpressionStreamIterator begin(){
+            return FusedExpressionStreamIterator(std::move(start_of_stream), std::move(end_of_stream));
+        }
+
+        /**
+         *  @brief ending value for expression stream iterator
+         *  @return null expression
+        **/
+        const Expression::expression_t end() const noexcept {
+            return Expression::expression_t(nullptr);
+        }
+};
+
+} // end of namespace parser
+
+#endif
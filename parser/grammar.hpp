@@ -0,0 +1,113 @@
+/**
+ *      @file parser/grammar.hpp
+ *      @brief defines helpers in namespace parser for building the parts of the grammar that do not depend on how blocks are represented
+ *      @author Anastasia Sokol
+ *
+ *      shared by ExpressionStream and FusedExpressionStream so that both report exactly the same errors
+**/
+
+#ifndef PARSER_GRAMMAR_H
+#define PARSER_GRAMMAR_H
+
+#include "../datatype/token.hpp"                    // defines Token which is converted into values
+#include "../expression/invalidexpression.hpp"      // defines InvalidExpression exception
+#include "../expression/expression.hpp"             // defines Expression::expression_t which is the result of each helper
+#include "../expression/atomicexpression.h"         // defines AtomicExpression
+#include "../expression/operatorexpression.h"       // defines OperatorExpression and OperatorExpression::OperatorType
+#include "../value/stringvalue.h"                   // defines StringValue::literal used to intern string literals
+#include "../value/numericvalue.h"                  // defines NumericValue::parse used to read numeric literals
+#include "../datatype/programstate.h"               // defines ProgramState::resolve used to intern reference names
+
+#include <list>                                     // defines std::list used to pass operator parameters
+#include <string>                                   // defines std::string used to report invalid operators
+#include <string_view>                              // defines std::string_view used to inspect token text
+#include <variant>                                  // defines std::variant used to return either a value or a reference slot
+
+namespace parser {
+
+/**
+ *  @brief convert a token into either a literal value or the slot of a reference
+ *  @desc names and string literals are interned straight from the token text, so repeated ones are neither copied nor allocated again
+ *  @throws InvalidExpression if the token does not represent a value
+**/
+inline std::variant<Value::value_t, ProgramState::slot_t> value_from_token(const Token &token){
+    using tt = Token::TokenType;
+    using vt = Value::value_t;
+
+    if(token.type == tt::reference){
+        return ProgramState::resolve(token.value);
+    }
+
+    if(token.type == tt::numeric){
+        return vt(NumericValue::parse(token.value));
+    } else if(token.type == tt::boolean){
+        return vt(token.value == "true");
+    } else if(token.type == tt::stringliteral){
+        return StringValue::literal(token.value);
+    }
+
+    throw InvalidExpression(token.position, "Expected a valued token but got a token of type [" + to_string(token.type) + "]");
+}
+
+/**
+ *  @brief build an atomic expression from a single token
+ *  @throws InvalidExpression if the token does not represent a value
+**/
+inline Expression::expression_t atomic_expression_from_token(const Token &token){
+    using exp_t = Expression::expression_t;
+    std::variant<Value::value_t, ProgramState::slot_t> value = value_from_token(token);
+    if(std::holds_alternative<Value::value_t>(value)){
+        return exp_t(new AtomicExpression(token.position, std::get<Value::value_t>(value)));
+    } else {
+        return exp_t(new AtomicExpression(token.position, std::get<ProgramState::slot_t>(value)));
+    }
+}
+
+/**
+ *  @brief build an operator expression from the text of an operation token
+ *  @param position of the block the operation is in
+ *  @param operation text of operation token
+ *  @param parameters already parsed operands
+ *  @throws InvalidExpression if operation is not a valid operator or has the wrong number of operands
+**/
+inline Expression::expression_t operator_expression(const Token::TokenPosition &position, const std::string_view operation, std::list<Expression::expression_t> parameters){
+    using exp_t = Expression::expression_t;
+    using optype = OperatorExpression::OperatorType;
+
+    switch(operation[0]){
+        case '+':
+            return exp_t(new OperatorExpression(position, optype::operator_add, std::move(parameters)));
+        
+        case '-':
+            return exp_t(new OperatorExpression(position, optype::operator_subtract, std::move(parameters)));
+        
+        case '*':
+            return exp_t(new OperatorExpression(position, optype::operator_multiply, std::move(parameters)));
+        
+        case '/':
+            return exp_t(new OperatorExpression(position, optype::operator_divide, std::move(parameters)));
+        
+        case '<':
+            return exp_t(new OperatorExpression(position, operation == "<=" ? optype::operator_less_or_equal : optype::operator_less, std::move(parameters)));
+        
+        case '>':
+            return exp_t(new OperatorExpression(position, operation == ">=" ? optype::operator_greater_or_equal : optype::operator_greater, std::move(parameters)));
+        
+        case '&':
+            if(operation != "&&"){ throw InvalidExpression(position, "Not a valid operator [" + std::string(operation) + "] (parse error)"); }
+            return exp_t(new OperatorExpression(position, optype::operator_and, std::move(parameters)));
+        
+        case '|':
+            if(operation != "||"){ throw InvalidExpression(position, "Not a valid operator [" + std::string(operation) + "] (parse error)"); }
+            return exp_t(new OperatorExpression(position, optype::operator_or, std::move(parameters)));
+        
+        case '!':
+            return exp_t(new OperatorExpression(position, optype::operator_not, std::move(parameters)));
+    };
+
+    throw InvalidExpression(position, "Invalid operator (parse error) [" + std::string(operation) + "]");
+}
+
+} // end of namespace parser
+
+#endif
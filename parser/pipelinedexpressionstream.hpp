@@ -0,0 +1,240 @@
+/**
+ *      @file parser/pipelinedexpressionstream.hpp
+ *      @brief defines class PipelinedExpressionStream in namespace parser for reading an expression stream on a background thread
+ *      @author Anastasia Sokol
+ *
+ *      the whole parse (lexing included) runs on its own thread and hands finished expressions over through a BoundedQueue
+ *      so that the thread running the program does not wait for the next expression to be parsed
+ *      errors are passed through the queue in place of the expression they stopped, so they are reported exactly where the expression stream would have reported them
+**/
+
+#ifndef PARSER_PIPELINEDEXPRESSIONSTREAM_H
+#define PARSER_PIPELINEDEXPRESSIONSTREAM_H
+
+#include "../expression/expression.hpp"     // defines Expression which is the type streamed
+#include "../datatype/boundedqueue.hpp"     // defines BoundedQueue used to pass expressions between threads
+
+#include <atomic>                           // defines std::atomic used to tell the parser thread to stop
+#include <condition_variable>               // defines std::condition_variable used to sleep until the other thread makes progress
+#include <cstddef>                          // defines std::size_t and std::ptrdiff_t
+#include <exception>                        // defines std::exception_ptr used to pass errors between threads
+#include <iterator>                         // defines std::input_iterator_tag
+#include <mutex>                            // defines std::mutex used to sleep until the other thread makes progress
+#include <thread>                           // defines std::thread which runs the parser
+#include <utility>                          // defines std::move
+
+namespace parser {
+
+/**
+ *  @brief runs an expression stream on a background thread, expressions are read from it in the same order
+**/
+class PipelinedExpressionStream {
+    private:
+        static constexpr std::size_t capacity = 64; // expressions parsed ahead of the one running
+
+        /**
+         *  @brief an expression, an error, or (if neither is set) the end of the stream
+        **/
+        struct Item {
+            Expression::expression_t expression;
+            std::exception_ptr error;
+        };
+
+        BoundedQueue<Item, capacity> queue;     // parsed expressions not yet read
+        std::atomic<bool> stopping;             // set when the stream is destroyed before the parser finished
+        std::thread parser;                     // thread reading the expression stream, started last
+
+        /**
+         *  @brief a side of the queue that may sleep until the other side makes progress
+        **/
+        struct Waiter {
+            std::atomic<bool> sleeping{false};  // set while blocked on woken, checked by the other side after every change
+            std::mutex lock;                    // held to sleep and to wake
+            std::condition_variable woken;      // signalled by the other side after a change while sleeping is set
+        };
+
+        Waiter producer;    // waits while the queue is full
+        Waiter consumer;    // waits while the queue is empty
+
+        /**
+         *  @brief wait until ready returns true, spinning briefly before going to sleep
+         *  @param waiter side that is waiting
+         *  @param ready checks if the queue changed, must also return true once the stream is stopping
+        **/
+        template <typename ready_t>
+        static void wait(Waiter &waiter, ready_t ready){
+            for(unsigned attempts = 0; attempts < 256; ++attempts){
+                if(ready()){
+                    return;
+                }
+            }
+
+            std::unique_lock<std::mutex> guard(waiter.lock);
+            waiter.sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            waiter.woken.wait(guard, ready);
+            waiter.sleeping.store(false);
+        }
+
+        /**
+         *  @brief wake a side after changing the queue, if it is sleeping
+        **/
+        static void wake(Waiter &waiter){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(waiter.sleeping.load()){
+                std::lock_guard<std::mutex> guard(waiter.lock);
+                waiter.woken.notify_one();
+            }
+        }
+
+        /**
+         *  @brief push an item, waiting for space (called from the parser thread)
+         *  @desc the consumer is only woken once half of the queue is full (or by the last item) so that the threads do not take turns for every item
+         *  @param item to push
+         *  @param last true if no more items will be pushed
+         *  @return false if the stream is being destroyed
+        **/
+        bool push(Item item, bool last = false){
+            wait(producer, [&](){ return stopping.load() || queue.try_push(item); });
+            if(stopping.load()){
+                return false;
+            }
+
+            if(last || queue.size() >= capacity / 2){
+                wake(consumer);
+            }
+            return true;
+        }
+
+        /**
+         *  @brief pop an item, waiting for the parser to produce one
+         *  @throws any error the parser ran into, in place of the expression it was reading
+         *  @return next expression, or nullptr at the end of the stream
+        **/
+        Expression::expression_t pop() noexcept(false) {
+            Item item;
+            wait(consumer, [&](){ return queue.try_pop(item); });
+
+            // the producer only sleeps while the queue is full
+            if(queue.size() <= capacity / 2){
+                wake(producer);
+            }
+
+            if(item.error){
+                std::rethrow_exception(item.error);
+            }
+
+            return std::move(item.expression);
+        }
+
+    public:
+        struct PipelinedExpressionStreamIterator {
+            private:
+                PipelinedExpressionStream *stream;  // stream expressions are read from
+                Expression::expression_t cursor;    // stores current expression
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = Expression::expression_t;
+                using pointer           = value_type*;
+                using reference         = value_type&;
+
+                /**
+                 *  @brief create iterator, waits for the first expression
+                 *  @param stream to read expressions from
+                **/
+                PipelinedExpressionStreamIterator(PipelinedExpressionStream *stream) : stream(stream) {
+                    ++*this;
+                }
+
+                /**
+                 *  @brief wait for next expression
+                 *  @return reference to stream
+                **/
+                PipelinedExpressionStreamIterator& operator ++() noexcept(false) {
+                    cursor = stream->pop();
+                    return *this;
+                }
+
+                /**
+                 *  @brief access expression cursor
+                 *  @desc pointer is invalidated after a call to operator ++()
+                 *  @return a constant pointer to the expression cursor
+                **/
+                inline const Expression::expression_t* operator ->() const noexcept {
+                    return &cursor;
+                }
+
+                /**
+                 *  @brief access expression cursor
+                 *  @desc reference is invalidated after a call to operator ++()
+                 *  @return a constant reference to the expression cursor
+                **/
+                inline const Expression::expression_t& operator *() const noexcept {
+                    return cursor;
+                }
+
+                /**
+                 *  @brief checks if the Expression::expression_t's have the some truthiness
+                 *  @return boolean (meant for testing end of stream)
+                **/
+                inline bool operator ==(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor == (bool)other;
+                }
+
+                /**
+                 *  @brief checks if the Expression::expression_t's have different truthiness
+                 *  @return boolean (meant for testing end of stream)
+                **/
+                inline bool operator !=(const Expression::expression_t &other) const noexcept {
+                    return (bool)cursor != (bool)other;
+                }
+        };
+
+        /**
+         *  @brief start parsing on a background thread
+         *  @desc names are resolved (see ProgramState::resolve) by the parser thread while expressions run, which the symbol table allows
+         *  @param open called on the parser thread, returns the expression stream to read (for example an ExpressionStream over a LexStream)
+        **/
+        template <typename open_t>
+        explicit PipelinedExpressionStream(open_t open) : stopping(false) {
+            RefCounted::share();
+            parser = std::thread([this, open = std::move(open)]() mutable {
+                try {
+                    for(const auto &expression : open()){
+                        if(!push(Item{expression, nullptr})){
+                            return;
+                        }
+                    }
+                    push(Item{nullptr, nullptr}, true);
+                } catch(...) {
+                    push(Item{nullptr, std::current_exception()}, true);
+                }
+            });
+        }
+
+        /**
+         *  @brief stop the parser (if it is still running) and wait for it
+        **/
+        ~PipelinedExpressionStream(){
+            stopping.store(true);
+            wake(producer);
+            parser.join();
+        }
+
+        PipelinedExpressionStream(const PipelinedExpressionStream&) = delete;
+        PipelinedExpressionStream& operator =(const PipelinedExpressionStream&) = delete;
+
+        PipelinedExpressionStreamIterator begin(){
+            return PipelinedExpressionStreamIterator(this);
+        }
+
+        const Expression::expression_t end() const noexcept {
+            return Expression::expression_t(nullptr);
+        }
+};
+
+} // end of namespace parser
+
+#endif
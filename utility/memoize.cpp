@@ -0,0 +1,118 @@
+#include "memoize.h"
+
+#include "../value/functionvalue.h"     // defines FunctionValue used to return memoized functions
+#include "../value/notimplemented.hpp"  // defines NotImplemented exception
+
+#include <algorithm>                    // defines std::min used to clamp capacities
+#include <cmath>                        // defines std::isfinite and std::floor used to check capacities
+#include <cstring>                      // defines std::memcpy used to read the bits of numerics
+#include <functional>                   // defines std::hash
+#include <utility>                      // defines std::move
+
+using namespace frstd;
+
+MemoCache::MemoCache(std::size_t capacity, std::shared_ptr<const std::atomic<bool>> stale) : capacity(capacity), stale(std::move(stale)) {}
+
+bool MemoCache::key(Value::arguments_t arguments, key_t &key) const {
+    if(stale && stale->load(std::memory_order_relaxed)){
+        return false;
+    }
+
+    key.reserve(arguments.size());
+    for(const auto &argument : arguments){
+        switch(argument.type()){
+            case ValueType::numeric:
+                {
+                    const double number = argument.numeric();
+                    std::uint64_t bits;
+                    std::memcpy(&bits, &number, sizeof(bits));
+                    key.emplace_back(bits);
+                }
+                break;
+
+            case ValueType::boolean:
+                key.emplace_back(argument.boolean());
+                break;
+
+            case ValueType::string:
+                key.emplace_back(argument.string());
+                break;
+
+            case ValueType::function:
+                // functions can not be compared, so there is nothing to look up
+                return false;
+        }
+    }
+    return true;
+}
+
+bool MemoCache::find(const key_t &key, Value::value_t &result){
+    std::lock_guard<std::mutex> guard(lock);
+    const auto found = index.find(key);
+    if(found == index.end()){
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    result = found->second->second;
+    return true;
+}
+
+void MemoCache::insert(key_t key, const Value::value_t &result){
+    std::lock_guard<std::mutex> guard(lock);
+    if(index.count(key)){
+        return;
+    }
+
+    if(entries.size() >= capacity){
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+
+    entries.emplace_front(key, result);
+    index.emplace(std::move(key), entries.begin());
+}
+
+std::size_t MemoCache::KeyHash::operator ()(const key_t &key) const noexcept {
+    std::size_t hash = key.size();
+    for(const auto &argument : key){
+        hash ^= std::hash<std::variant<std::uint64_t, bool, std::string>>()(argument) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+Memoized::Memoized(Value::function_t function, std::size_t capacity) : function(std::move(function)), cache(std::make_shared<MemoCache>(capacity)) {}
+
+Value::value_t Memoized::operator ()(Value::arguments_t arguments) const {
+    MemoCache::key_t key;
+    if(!cache->key(arguments, key)){
+        return function(arguments);
+    }
+
+    Value::value_t result;
+    if(cache->find(key, result)){
+        return result;
+    }
+
+    // the call may use (and change) the cache itself, so the cache is not locked during it
+    result = function(arguments);
+    cache->insert(std::move(key), result);
+    return result;
+}
+
+Value::value_t frstd::memo(Value::arguments_t arguments){
+    if(arguments.empty() || arguments.size() > 2 || arguments.front().type() != ValueType::function){
+        throw NotImplemented("'memo' standard library function expects a function and an optional cache size");
+    }
+
+    std::size_t capacity = MemoCache::default_capacity;
+    if(arguments.size() == 2){
+        const Value::value_t &size = arguments.back();
+        if(size.type() != ValueType::numeric || !std::isfinite(size.numeric()) || size.numeric() < 1 || size.numeric() != std::floor(size.numeric())){
+            throw NotImplemented("'memo' standard library function expects cache size to be a positive whole numeric");
+        }
+        capacity = std::min(size.numeric(), (double)MemoCache::largest_capacity);
+    }
+
+    return Value::value_t::make<FunctionValue>(Memoized(arguments.front().function(), capacity));
+}
@@ -0,0 +1,126 @@
+/**
+ *      @file utility/memoize.h
+ *      @brief defines frstd::MemoCache, which caches results by argument values, and frstd::Memoized, a function value wrapper around one
+ *      @author Anastasia Sokol
+ *
+ *      Memoized is used by the memo standard library function, lambdas that are memoized automatically (see --memo=auto and Expression::pure)
+ *      keep a MemoCache in their closures instead
+**/
+
+#ifndef UTILITY_MEMOIZE_H
+#define UTILITY_MEMOIZE_H
+
+#include "../value/value.hpp"   // defines Value::value_t and Value::function_t
+
+#include <atomic>               // defines std::atomic used to mark results stale
+#include <cstddef>              // defines std::size_t
+#include <cstdint>              // defines std::uint64_t used to store numeric arguments by their bits
+#include <list>                 // defines std::list used to keep entries in order of use
+#include <memory>               // defines std::shared_ptr used to share a cache between copies of a function
+#include <mutex>                // defines std::mutex used to guard a cache shared by worker threads (see frstd::pmap)
+#include <string>               // defines std::string used in keys
+#include <unordered_map>        // defines std::unordered_map used to find entries
+#include <variant>              // defines std::variant used to store a single argument of a key
+#include <vector>               // defines std::vector used to store every argument of a key
+
+namespace frstd {
+
+/**
+ *  @brief bounded least recently used map from the values of arguments to results
+ *
+ *  only calls where every argument is numeric, string, or boolean can be cached (calls with function arguments are always made)
+ *  the cache is locked while it is read or changed (but not during calls), so it can be shared by several threads
+ *  used by Memoized, and directly by the calls of lambdas that are memoized automatically (see LambdaExpression::Closure and vm::Machine)
+ *  so that memoized recursion runs as deep as any other
+**/
+class MemoCache {
+    public:
+        // argument values, in order, numerics are stored by their bits so that a NaN finds itself and -0 is not 0
+        typedef std::vector<std::variant<std::uint64_t, bool, std::string>> key_t;
+
+        static constexpr std::size_t default_capacity = 4096;   // number of results kept if no capacity is given
+        static constexpr std::size_t largest_capacity = 1 << 24; // larger capacities given to memo are clamped to this
+
+        /**
+         *  @brief create empty cache
+         *  @param capacity maximum number of cached results (must be at least one)
+         *  @param stale once true nothing is cached or found anymore (see LambdaExpression::define), nullptr if results never go stale
+        **/
+        MemoCache(std::size_t = default_capacity, std::shared_ptr<const std::atomic<bool>> = nullptr);
+
+        /**
+         *  @brief make the key of a call
+         *  @param arguments of call
+         *  @param key filled with the values of arguments
+         *  @return false if the call can not be cached (an argument is a function, or results went stale)
+        **/
+        bool key(Value::arguments_t, key_t&) const;
+
+        /**
+         *  @brief find the result of a call, marking it most recently used
+         *  @param key of call (see MemoCache::key)
+         *  @param result set if found
+         *  @return true if found
+        **/
+        bool find(const key_t&, Value::value_t&);
+
+        /**
+         *  @brief store the result of a call, dropping the least recently used one if full
+         *  @desc does nothing if the key was stored in the meantime (by the call itself, or another thread)
+         *  @param key of call (see MemoCache::key)
+         *  @param result of call
+        **/
+        void insert(key_t, const Value::value_t&);
+
+    private:
+        /**
+         *  @brief hash every argument of a key
+        **/
+        struct KeyHash {
+            std::size_t operator ()(const key_t&) const noexcept;
+        };
+
+        typedef std::list<std::pair<key_t, Value::value_t>> entries_t;
+
+        std::mutex lock;                                                    // guards entries and index
+        const std::size_t capacity;                                         // maximum size of entries
+        const std::shared_ptr<const std::atomic<bool>> stale;               // see constructor
+        entries_t entries;                                                  // most recently used first
+        std::unordered_map<key_t, entries_t::iterator, KeyHash> index;      // position of every key in entries
+};
+
+/**
+ *  @brief callable wrapping a function, results are cached by the values of the arguments (see MemoCache)
+**/
+class Memoized {
+    public:
+        /**
+         *  @brief wrap function
+         *  @param function to call on cache misses
+         *  @param capacity maximum number of cached results (must be at least one)
+        **/
+        Memoized(Value::function_t, std::size_t = MemoCache::default_capacity);
+
+        /**
+         *  @brief get cached result or call function
+         *  @param arguments to call function with
+         *  @return result of function for arguments
+        **/
+        Value::value_t operator ()(Value::arguments_t) const;
+
+    private:
+        Value::function_t function;         // function being memoized
+        std::shared_ptr<MemoCache> cache;   // shared by copies so that every copy of the function value sees the same results
+};
+
+/**
+ *  @brief memoize a function
+ *  @param values function to memoize, optionally followed by the maximum number of results to keep
+ *  @throws NotImplemented if the arguments are not a function and an optional positive whole numeric
+ *  @return function that returns the same results as the one given, reusing previous results for the same arguments
+**/
+Value::value_t memo(Value::arguments_t);
+
+}  // end of namespace frstd
+
+#endif
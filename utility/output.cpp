@@ -0,0 +1,61 @@
+#include "output.h"
+
+#include <iostream>     // defines std::cout used if no sink exists
+
+using namespace frstd;
+
+static Output *active = nullptr;    // most recently created sink that still exists
+
+Output& Output::current(){
+    if(!active){
+        // becomes current itself, and stays at the bottom of every sink created later
+        static StreamOutput fallback(std::cout, 0);
+    }
+    return *active;
+}
+
+Output::Output() : previous(active) {
+    active = this;
+}
+
+Output::~Output(){
+    active = previous;
+}
+
+StreamOutput::StreamOutput(std::ostream &stream, std::size_t capacity) : stream(stream), capacity(capacity) {
+    buffer.reserve(capacity);
+}
+
+StreamOutput::~StreamOutput(){
+    flush();
+}
+
+void StreamOutput::write(std::string_view text){
+    std::lock_guard<std::mutex> guard(lock);
+
+    if(buffer.size() + text.size() > capacity){
+        drain();
+
+        if(text.size() >= capacity){
+            // would not fit anyway, skip the copy
+            stream.write(text.data(), text.size());
+            stream.flush();
+            return;
+        }
+    }
+
+    buffer.append(text);
+}
+
+void StreamOutput::flush(){
+    std::lock_guard<std::mutex> guard(lock);
+    drain();
+}
+
+void StreamOutput::drain(){
+    if(!buffer.empty()){
+        stream.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    stream.flush();
+}
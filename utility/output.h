@@ -0,0 +1,97 @@
+/**
+ *      @file utility/output.h
+ *      @brief defines frstd::Output, the sink the standard library writes printed text to
+ *      @author Anastasia Sokol
+ *
+ *      the most recently created sink that still exists is the one used, so a sink can be swapped in for a scope (main creates one for the whole program)
+ *      if no sink exists text is written straight to std::cout and flushed after every write
+**/
+
+#ifndef UTILITY_OUTPUT_H
+#define UTILITY_OUTPUT_H
+
+#include <cstddef>      // defines std::size_t
+#include <mutex>        // defines std::mutex used so that workers of pmap and preduce can print
+#include <ostream>      // defines std::ostream which StreamOutput writes to
+#include <string>       // defines std::string used to buffer text
+#include <string_view>  // defines std::string_view used to pass text
+
+namespace frstd {
+
+/**
+ *  @brief somewhere to write printed text
+**/
+class Output {
+    private:
+        Output *previous;   // sink that was current when this one was created
+
+    public:
+        /**
+         *  @brief get the sink print and println write to
+         *  @return most recently created sink, or an unbuffered sink over std::cout
+        **/
+        static Output& current();
+
+        /**
+         *  @brief make this the current sink until it is destroyed
+        **/
+        Output();
+
+        /**
+         *  @brief make the previous sink current again, sinks must be destroyed in the opposite order they were created in
+        **/
+        virtual ~Output();
+
+        Output(const Output&) = delete;
+        Output& operator =(const Output&) = delete;
+
+        /**
+         *  @brief write text (it may not be visible until flush is called)
+         *  @param text to write
+        **/
+        virtual void write(std::string_view) = 0;
+
+        /**
+         *  @brief make everything written so far visible
+        **/
+        virtual void flush() = 0;
+};
+
+/**
+ *  @brief sink that collects text in a buffer and writes it to a stream once the buffer is full, when flushed, or when destroyed
+**/
+class StreamOutput : public Output {
+    public:
+        static constexpr std::size_t default_capacity = 1 << 16;    // bytes buffered before writing to the stream
+
+        /**
+         *  @brief create and make current
+         *  @param stream to write to, must outlive the sink
+         *  @param capacity bytes to buffer, 0 to write and flush the stream on every write
+        **/
+        StreamOutput(std::ostream&, std::size_t = default_capacity);
+
+        /**
+         *  @brief flush anything left in the buffer
+        **/
+        ~StreamOutput();
+
+        void write(std::string_view);
+
+        void flush();
+
+    private:
+        std::ostream &stream;   // where text ends up
+        std::size_t capacity;   // size buffer may grow to
+        std::string buffer;     // text not yet written to stream
+        std::mutex lock;        // guards buffer and stream
+
+        /**
+         *  @brief write buffer to stream and flush it, lock must be held
+        **/
+        void drain();
+};
+
+}  // end of namespace frstd
+
+#endif
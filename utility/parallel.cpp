@@ -0,0 +1,180 @@
+#include "parallel.h"
+
+#include "threadpool.h"                 // defines frstd::ThreadPool which runs the calls
+#include "../datatype/programstate.h"   // defines ProgramState used by each worker
+#include "../value/functionvalue.h"     // defines FunctionValue used to return the results of pmap
+#include "../value/notimplemented.hpp"  // defines NotImplemented exception
+#include "../vm/machine.h"              // defines vm::Machine used by each worker to run closures created by the vm
+
+#include <algorithm>                    // defines std::sort used to put partial results of preduce back in order
+#include <cmath>                        // defines std::floor and std::isfinite used to check counts and indices
+#include <functional>                   // defines std::function used to pass ranges of calls
+#include <memory>                       // defines std::unique_ptr and std::shared_ptr
+#include <mutex>                        // defines std::mutex used to collect partial results of preduce
+#include <utility>                      // defines std::pair and std::move
+#include <vector>                       // defines std::vector used to store results
+
+using namespace frstd;
+
+using value_t = Value::value_t;
+
+namespace {
+
+/**
+ *  @brief state and machine of a single participant in a parallel call
+**/
+struct Worker {
+    ProgramState state;     // layered over the state of the caller
+    vm::Machine machine;    // runs closures created by the vm on state
+
+    explicit Worker(const ProgramState *base) : state(base), machine(state) {}
+};
+
+/**
+ *  @brief makes closures called on this thread run in a worker until destroyed
+**/
+class Enter {
+    private:
+        ProgramState *state;
+        vm::Machine *machine;
+
+    public:
+        explicit Enter(Worker &worker) : state(ProgramState::current), machine(vm::Machine::current) {
+            ProgramState::current = &worker.state;
+            vm::Machine::current = &worker.machine;
+        }
+
+        ~Enter(){
+            ProgramState::current = state;
+            vm::Machine::current = machine;
+        }
+};
+
+/**
+ *  @brief function_t target returned by pmap, looks up the result for an index
+**/
+struct Results {
+    std::shared_ptr<const std::vector<value_t>> values;
+
+    value_t operator ()(Value::arguments_t arguments) const {
+        if(arguments.size() != 1 || arguments.front().type() != ValueType::numeric){
+            throw NotImplemented("function returned by 'pmap' expects a single numeric index");
+        }
+
+        const double index = arguments.front().numeric();
+        if(index < 0 || index >= values->size() || index != std::floor(index)){
+            throw NotImplemented("index passed to function returned by 'pmap' is out of range");
+        }
+
+        return (*values)[index];
+    }
+};
+
+constexpr double largest_count = 4294967296.0;  // 2^32, larger counts are rejected before they are converted to std::size_t
+
+/**
+ *  @brief check that a value is a whole numeric in [minimum, largest_count]
+**/
+bool count(const value_t &value, double minimum){
+    if(value.type() != ValueType::numeric){
+        return false;
+    }
+
+    const double number = value.numeric();
+    return std::isfinite(number) && number >= minimum && number <= largest_count && number == std::floor(number);
+}
+
+/**
+ *  @brief run body over every index in [0, count) on the shared thread pool, each participant in its own worker
+ *  @desc without a current state (nothing to layer workers over) body is run over the whole range on the calling thread
+ *  @param count number of indices
+ *  @param body called with [begin, end) of each chunk
+**/
+void parallel(std::size_t count, const std::function<void(std::size_t, std::size_t)> &body){
+    const ProgramState *const base = ProgramState::current;
+    if(!base){
+        if(count){
+            body(0, count);
+        }
+        return;
+    }
+
+    ThreadPool &pool = ThreadPool::shared();
+
+    // created by the participant that uses it, a participant is only ever one thread at a time
+    std::vector<std::unique_ptr<Worker>> workers(pool.size());
+
+    pool.run(count, [&](std::size_t participant, std::size_t begin, std::size_t end){
+        std::unique_ptr<Worker> &worker = workers[participant];
+        if(!worker){
+            worker = std::make_unique<Worker>(base);
+        }
+
+        Enter entered(*worker);
+        body(begin, end);
+    });
+}
+
+/**
+ *  @brief call function with a single index
+**/
+value_t call(const Value::function_t &function, std::size_t index){
+    const value_t argument((double)index);
+    return function(Value::arguments_t(&argument, 1));
+}
+
+}  // end of anonymous namespace
+
+value_t frstd::pmap(Value::arguments_t arguments){
+    if(arguments.size() != 2 || arguments[0].type() != ValueType::function || !count(arguments[1], 0)){
+        throw NotImplemented("'pmap' standard library function expects a function and a non negative whole numeric count (at most 2^32)");
+    }
+
+    const Value::function_t &function = arguments[0].function();
+    const std::size_t size = arguments[1].numeric();
+
+    auto results = std::make_shared<std::vector<value_t>>(size);
+
+    parallel(size, [&](std::size_t begin, std::size_t end){
+        for(std::size_t index = begin; index < end; ++index){
+            (*results)[index] = call(function, index);
+        }
+    });
+
+    return value_t::make<FunctionValue>(Results{std::move(results)});
+}
+
+value_t frstd::preduce(Value::arguments_t arguments){
+    if(arguments.size() != 3 || arguments[0].type() != ValueType::function || arguments[1].type() != ValueType::function || !count(arguments[2], 1)){
+        throw NotImplemented("'preduce' standard library function expects a combining function, a function, and a positive whole numeric count (at most 2^32)");
+    }
+
+    const Value::function_t &combine = arguments[0].function();
+    const Value::function_t &function = arguments[1].function();
+    const std::size_t size = arguments[2].numeric();
+
+    // result of every chunk, keyed by its first index
+    std::vector<std::pair<std::size_t, value_t>> partials;
+    std::mutex lock;
+
+    parallel(size, [&](std::size_t begin, std::size_t end){
+        value_t result = call(function, begin);
+        for(std::size_t index = begin + 1; index < end; ++index){
+            const value_t pair[] = {std::move(result), call(function, index)};
+            result = combine(Value::arguments_t(pair, 2));
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        partials.emplace_back(begin, std::move(result));
+    });
+
+    std::sort(partials.begin(), partials.end(), [](const auto &lhs, const auto &rhs){ return lhs.first < rhs.first; });
+
+    value_t result = std::move(partials.front().second);
+    for(auto partial = partials.begin() + 1; partial != partials.end(); ++partial){
+        const value_t pair[] = {std::move(result), std::move(partial->second)};
+        result = combine(Value::arguments_t(pair, 2));
+    }
+
+    return result;
+}
@@ -0,0 +1,38 @@
+/**
+ *      @file utility/parallel.h
+ *      @brief defines the parallel standard library functions pmap and preduce
+ *      @author Anastasia Sokol
+ *
+ *      both call a function once for every index of a range, spread over every core by frstd::ThreadPool
+ *      each worker runs in its own ProgramState layered over the state of the caller (and on its own vm::Machine), so it can read anything the caller can see
+ *      references set by the function (including its parameters) stay local to the worker, and the caller is blocked until every call is done
+ *      the function should be pure, calls happen in no particular order (output from print or println may be interleaved)
+**/
+
+#ifndef UTILITY_PARALLEL_H
+#define UTILITY_PARALLEL_H
+
+#include "../value/value.hpp"   // defines Value::value_t and Value::arguments_t
+
+namespace frstd {
+
+/**
+ *  @brief call a function for every index in [0, count) in parallel
+ *  @param values function taking one numeric argument, and count (a non negative whole numeric, at most 2^32)
+ *  @throws NotImplemented if the arguments are not a function and a count, or the first exception thrown by a call
+ *  @return function taking an index in [0, count) and returning the result of the call for that index
+**/
+Value::value_t pmap(Value::arguments_t);
+
+/**
+ *  @brief call a function for every index in [0, count) in parallel and combine the results in order
+ *  @desc combine must be associative, results of neighbouring indices are combined on the worker that made the calls before being combined with the results of other workers
+ *  @param values combine function taking two arguments, function taking one numeric argument, and count (a positive whole numeric, at most 2^32)
+ *  @throws NotImplemented if the arguments are not two functions and a count, or the first exception thrown by a call
+ *  @return (combine ... (combine (combine (f 0) (f 1)) (f 2)) ... (f count - 1)), grouped in some way
+**/
+Value::value_t preduce(Value::arguments_t);
+
+}  // end of namespace frstd
+
+#endif
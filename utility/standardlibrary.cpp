@@ -2,48 +2,74 @@
 
 #include "../value/value.hpp"           // defines Value
 #include "../value/stringvalue.h"       // defines StringValue
-#include "../value/numericvalue.h"      // defines NumericValue
 #include "../value/booleanvalue.h"      // defines BooleanValue
+#include "../value/numericvalue.h"      // defines NumericValue::format and NumericValue::parse
 #include "../value/notimplemented.hpp"  // defines NotImplemented exception
+#include "output.h"                     // defines frstd::Output which printed text is written to
 
-#include <iostream>     // defines std::cout and std::endl (newline and flush buffer)
+#include <iostream>     // defines std::cin
 
 #include <cctype>       // defines std::isspace and std::isdigit for pattern matching
 
-Value::value_t frstd::print(std::list<Value::value_t> values){
+/**
+ *  @brief append the text of value to output, numerics are formatted in place instead of through a temporary string
+**/
+static void append(std::string &output, const Value::value_t &value){
+    if(value.type() == ValueType::numeric){
+        char buffer[NumericValue::format_capacity];
+        output.append(buffer, NumericValue::format(value.numeric(), buffer));
+    } else {
+        output += (std::string)value;
+    }
+}
+
+Value::value_t frstd::print(Value::arguments_t values){
     std::string output;
     for(const auto &value : values){
-        output += (std::string)*value;
+        append(output, value);
     }
-    std::cout << output;
-    std::cout.flush();
-    return Value::value_t(new StringValue(output));
+    Output::current().write(output);
+    return Value::value_t::make<StringValue>(output);
 }
 
-Value::value_t frstd::println(std::list<Value::value_t> values){
+Value::value_t frstd::println(Value::arguments_t values){
     std::string output;
     for(const auto &value : values){
-        output += (std::string)*value;
+        append(output, value);
+    }
+    Output::current().write(output + '\n');
+    return Value::value_t::make<StringValue>(output);
+}
+
+Value::value_t frstd::flush(Value::arguments_t arguments){
+    if(arguments.size()){
+        throw NotImplemented("'flush' standard library function does not accept arguments");
     }
-    std::cout << output << std::endl;
-    return Value::value_t(new StringValue(output));
+
+    Output::current().flush();
+    return Value::value_t(true);
 }
 
-Value::value_t frstd::readline(std::list<Value::value_t> arguments){
+Value::value_t frstd::readline(Value::arguments_t arguments){
     if(arguments.size()){
         throw NotImplemented("'readline' standard library function does not accept arguments");
     }
 
+    // make sure any prompt is visible before waiting for input
+    Output::current().flush();
+
     std::string line;
     std::getline(std::cin, line);
-    return Value::value_t(new StringValue(line));
+    return Value::value_t::make<StringValue>(line);
 }
 
-Value::value_t frstd::readnumeric(std::list<Value::value_t> arguments){
+Value::value_t frstd::readnumeric(Value::arguments_t arguments){
     if(arguments.size()){
         throw NotImplemented("'readnumeric' standard library function does not accept arguments");
     }
 
+    Output::current().flush();
+
     std::string line;
     
     while(true) {
@@ -55,5 +81,5 @@ Value::value_t frstd::readnumeric(std::list<Value::value_t> arguments){
         }
     }
 
-    return Value::value_t(new NumericValue(std::stod(line)));
+    return Value::value_t(NumericValue::parse(line));
 }
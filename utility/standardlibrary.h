@@ -4,9 +4,12 @@
  *      @author Anastasia Sokol
 **/
 
+#ifndef UTILITY_STANDARDLIBRARY_H
+#define UTILITY_STANDARDLIBRARY_H
+
 #include "../value/value.hpp"   // defines Value
 
-#include <list>                 // defines std::list
+#include <string>               // defines std::string used to name standard library functions
 
 namespace frstd {
 
@@ -15,27 +18,36 @@ namespace frstd {
  *  @param values to print
  *  @return a StringValue containing all the values printed together 
 **/
-Value::value_t print(std::list<Value::value_t>);
+Value::value_t print(Value::arguments_t);
 
 /**
  *  @brief takes a list of values and prints them out with trailing newline
  *  @param values to print
  *  @return a StringValue containing all the values printed together
 **/
-Value::value_t println(std::list<Value::value_t>);
+Value::value_t println(Value::arguments_t);
+
+/**
+ *  @brief make everything printed so far visible (see frstd::Output)
+ *  @param values must be an empty list
+ *  @return true
+**/
+Value::value_t flush(Value::arguments_t);
 
 /**
- *  @brief read a line from the user
+ *  @brief read a line from the user, printed text is flushed first
  *  @param values must be an empty list
  *  @return line read from user
 **/
-Value::value_t readline(std::list<Value::value_t>);
+Value::value_t readline(Value::arguments_t);
 
 /**
- *  @brief read a number from the user
+ *  @brief read a number from the user, printed text is flushed first
  *  @param values must be an empty list or a default value for if the user does not enter a number
  *  @return number read from user
 **/
-Value::value_t readnumeric(std::list<Value::value_t>);
+Value::value_t readnumeric(Value::arguments_t);
+
+}  // end of namespace frstd
 
-}  // end of namespace frstd
\ No newline at end of file
+#endif
@@ -0,0 +1,162 @@
+#include "threadpool.h"
+
+#include "../datatype/refcounted.hpp"   // defines RefCounted::share called before threads start
+
+#include <algorithm>    // defines std::max and std::min
+
+using namespace frstd;
+
+std::size_t ThreadPool::participants = 0;
+
+ThreadPool& ThreadPool::shared(){
+    static ThreadPool pool(participants ? participants : std::thread::hardware_concurrency());
+    return pool;
+}
+
+ThreadPool::ThreadPool(std::size_t participants) : queues(std::max<std::size_t>(participants, 1)) {
+    threads.reserve(queues.size() - 1);
+    if(queues.size() > 1){
+        RefCounted::share();
+    }
+    for(std::size_t participant = 1; participant < queues.size(); ++participant){
+        threads.emplace_back(&ThreadPool::work, this, participant);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    started.notify_all();
+
+    for(std::thread &thread : threads){
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::size() const noexcept {
+    return queues.size();
+}
+
+void ThreadPool::run(std::size_t count, const task_t &job_task){
+    if(!count){
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+
+    if(running || threads.empty() || count == 1){
+        guard.unlock();
+        job_task(0, 0, count);
+        return;
+    }
+
+    // several chunks per participant so that uneven chunks can be balanced by stealing
+    const std::size_t grain = std::max<std::size_t>(count / (queues.size() * 8), 1);
+    const std::size_t chunks = (count + grain - 1) / grain;
+
+    for(std::size_t participant = 0; participant < queues.size(); ++participant){
+        const std::size_t first = chunks * participant / queues.size();
+        const std::size_t last = chunks * (participant + 1) / queues.size();
+
+        std::lock_guard<std::mutex> queued(queues[participant].lock);
+        for(std::size_t chunk = first; chunk < last; ++chunk){
+            queues[participant].chunks.emplace_back(chunk * grain, std::min((chunk + 1) * grain, count));
+        }
+    }
+
+    task = &job_task;
+    failed = false;
+    failure = nullptr;
+    active = threads.size();
+    running = true;
+    ++job;
+
+    guard.unlock();
+    started.notify_all();
+
+    drain(0);
+
+    guard.lock();
+    finished.wait(guard, [this](){ return !active; });
+
+    running = false;
+    task = nullptr;
+    std::exception_ptr error = std::move(failure);
+    failure = nullptr;
+    guard.unlock();
+
+    if(error){
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::work(std::size_t participant){
+    std::size_t seen = 0;   // last job taken part in
+
+    std::unique_lock<std::mutex> guard(lock);
+    while(true){
+        started.wait(guard, [&](){ return stopping || job != seen; });
+        if(stopping){
+            return;
+        }
+        seen = job;
+
+        guard.unlock();
+        drain(participant);
+        guard.lock();
+
+        if(!--active){
+            finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::drain(std::size_t participant){
+    chunk_t chunk;
+    while(next(participant, chunk)){
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if(failed){
+                // keep emptying the queues so that the next job starts with none left over
+                continue;
+            }
+        }
+
+        try {
+            (*task)(participant, chunk.first, chunk.second);
+        } catch(...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(!failed){
+                failed = true;
+                failure = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::next(std::size_t participant, chunk_t &chunk){
+    {
+        Queue &own = queues[participant];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if(!own.chunks.empty()){
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the chunk furthest from where the owner is working
+    for(std::size_t offset = 1; offset < queues.size(); ++offset){
+        Queue &victim = queues[(participant + offset) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.chunks.empty()){
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,122 @@
+/**
+ *      @file utility/threadpool.h
+ *      @brief defines frstd::ThreadPool, a work stealing pool of threads used to run the parallel standard library functions
+ *      @author Anastasia Sokol
+ *
+ *      a job is a range of indices split into chunks, every participant starts with an equal share of chunks in its own queue
+ *      participants take chunks from the back of their own queue and, once it is empty, steal from the front of the queues of others
+ *      the thread that starts a job takes part in it, so a pool of n participants only owns n - 1 threads
+**/
+
+#ifndef UTILITY_THREADPOOL_H
+#define UTILITY_THREADPOOL_H
+
+#include <condition_variable>   // defines std::condition_variable used to wake threads when a job starts and the caller when it ends
+#include <cstddef>              // defines std::size_t
+#include <deque>                // defines std::deque used for the queue of chunks of each participant
+#include <exception>            // defines std::exception_ptr used to pass the first failure of a job back to the caller
+#include <functional>           // defines std::function used to store the task of a job
+#include <mutex>                // defines std::mutex used to guard queues and job state
+#include <thread>               // defines std::thread
+#include <utility>              // defines std::pair used to represent chunks
+#include <vector>               // defines std::vector used to store threads and queues
+
+namespace frstd {
+
+/**
+ *  @brief fixed set of threads that run jobs over ranges of indices, balancing chunks between threads by stealing
+**/
+class ThreadPool {
+    public:
+        /**
+         *  @brief work done for one chunk of a job
+         *  @param participant index of the participant running the chunk, less than size(), a participant is only ever one thread at a time
+         *  @param begin first index of chunk
+         *  @param end one past the last index of chunk
+        **/
+        typedef std::function<void(std::size_t, std::size_t, std::size_t)> task_t;
+
+        static std::size_t participants;    // size of the shared pool, 0 for one participant per hardware thread (see --threads)
+
+        /**
+         *  @brief get the pool shared by the whole program, created on first use with ThreadPool::participants participants
+        **/
+        static ThreadPool& shared();
+
+        /**
+         *  @brief create pool
+         *  @param participants number of threads that take part in a job, including the caller (at least one)
+        **/
+        explicit ThreadPool(std::size_t);
+
+        /**
+         *  @brief stop and join every thread
+        **/
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator =(const ThreadPool&) = delete;
+
+        /**
+         *  @brief number of participants, including the caller
+        **/
+        std::size_t size() const noexcept;
+
+        /**
+         *  @brief run task over every index in [0, count), blocking until every chunk is done
+         *  @desc jobs started from inside of a task (or while another job is running) are run on the calling thread alone as participant 0
+         *  @param count number of indices
+         *  @param task to run for each chunk
+         *  @throws the first exception thrown by task, chunks that were not started yet are skipped once a task fails
+        **/
+        void run(std::size_t, const task_t&);
+
+    private:
+        typedef std::pair<std::size_t, std::size_t> chunk_t;   // [begin, end) of indices
+
+        /**
+         *  @brief chunks waiting to be run by one participant, others steal from the front
+        **/
+        struct Queue {
+            std::mutex lock;
+            std::deque<chunk_t> chunks;
+        };
+
+        std::vector<std::thread> threads;   // participants 1 to size() - 1
+        std::vector<Queue> queues;          // one for every participant
+
+        std::mutex lock;                    // guards every member below
+        std::condition_variable started;    // signalled when a job starts or the pool stops
+        std::condition_variable finished;   // signalled when the last thread leaves a job
+        const task_t *task = nullptr;       // task of current job
+        std::size_t job = 0;                // number of jobs started, lets threads tell a new job from one they already took part in
+        std::size_t active = 0;             // threads (not counting the caller) still inside of the current job
+        bool running = false;               // a job is in progress, new jobs run on the calling thread
+        bool stopping = false;              // set by the destructor
+        bool failed = false;                // a chunk of the current job threw, remaining chunks are skipped
+        std::exception_ptr failure;         // first exception of the current job
+
+        /**
+         *  @brief body of every thread, waits for jobs and takes part in them
+         *  @param participant index of the thread
+        **/
+        void work(std::size_t);
+
+        /**
+         *  @brief run chunks from own queue, then stolen ones, until every queue is empty
+         *  @param participant index of the calling participant
+        **/
+        void drain(std::size_t);
+
+        /**
+         *  @brief take the next chunk for a participant
+         *  @param participant index of the calling participant
+         *  @param chunk set to the chunk taken
+         *  @return false if every queue is empty
+        **/
+        bool next(std::size_t, chunk_t&);
+};
+
+}  // end of namespace frstd
+
+#endif
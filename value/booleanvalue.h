@@ -13,6 +13,8 @@
  *  @brief boolean value designed to be used in a weakly typed manor with other value types
 **/
 struct BooleanValue : public Value {
+    bool boolean;   // stored value
+
     /**
      *  @brief construct a value object from boolean value
      *  @param value is the boolean value that the object will begin with 
@@ -95,4 +97,7 @@ struct BooleanValue : public Value {
     operator bool() const;
 };
 
+// size budget, see benchmark/footprint
+static_assert(sizeof(BooleanValue) <= 16, "a boolean should fit in the padding of the base");
+
 #endif
\ No newline at end of file
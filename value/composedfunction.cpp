@@ -0,0 +1,190 @@
+#include "composedfunction.h"
+
+#include "booleanvalue.h"       // defines BooleanValue read when a boolean operand is copied
+#include "dispatch.h"           // defines dispatch::apply used to apply steps
+#include "functionvalue.h"      // defines FunctionValue which holds compositions and leaves
+#include "numericvalue.h"       // defines NumericValue read when a numeric operand is copied
+#include "stringvalue.h"        // defines StringValue used to box string operands
+#include "notimplemented.hpp"   // defines NotImplemented thrown for unknown operations
+
+#include <unordered_map>        // defines std::unordered_map used to find shared leaves and nodes while flattening
+#include <utility>              // defines std::move and std::pair
+
+using value_t = Value::value_t;
+
+value_t ComposedFunction::compose(Operation operation, const Value &lhs, const value_t &rhs){
+    return value_t::make<FunctionValue>(ComposedFunction(std::make_shared<const Node>(operation, Operand::from(lhs), Operand::from(rhs))));
+}
+
+value_t ComposedFunction::compose(Operation operation, const Value &operand){
+    return value_t::make<FunctionValue>(ComposedFunction(std::make_shared<const Node>(operation, Operand::from(operand), Operand{})));
+}
+
+value_t ComposedFunction::operator ()(Value::arguments_t arguments) const {
+    const Program &program = root->flatten();
+
+    std::vector<value_t> leaves;
+    leaves.reserve(program.leaves.size());
+    for(const Value::function_t *leaf : program.leaves){
+        leaves.push_back((*leaf)(arguments));
+    }
+
+    std::vector<value_t> steps;
+    steps.reserve(program.steps.size());
+
+    const auto input = [&](const Source &source) -> const value_t& {
+        switch(source.kind){
+            case Source::Kind::constant:
+                return *program.constants[source.index];
+
+            case Source::Kind::leaf:
+                return leaves[source.index];
+
+            case Source::Kind::step:
+                break;
+        }
+
+        return steps[source.index];
+    };
+
+    for(const Step &step : program.steps){
+        steps.push_back(apply(step.operation, input(step.lhs), input(step.rhs)));
+    }
+
+    return std::move(steps.back());
+}
+
+ComposedFunction::ComposedFunction(std::shared_ptr<const Node> root) : root(std::move(root)) {}
+
+value_t ComposedFunction::apply(Operation operation, const value_t &lhs, const value_t &rhs){
+    if(operation == Operation::logical_not){
+        return !lhs;
+    }
+
+    if(static_cast<std::size_t>(operation) >= dispatch::operations){
+        throw NotImplemented("Unknown operation in composed function");
+    }
+
+    return dispatch::apply(operation, lhs, rhs);
+}
+
+/**
+ *  Implimentation of nested structure ComposedFunction::Operand
+**/
+
+ComposedFunction::Operand ComposedFunction::Operand::from(const Value &value){
+    switch(value.type){
+        case ValueType::numeric:
+            return Operand{value_t(static_cast<const NumericValue&>(value).number), nullptr, nullptr};
+
+        case ValueType::boolean:
+            return Operand{value_t(static_cast<const BooleanValue&>(value).boolean), nullptr, nullptr};
+
+        case ValueType::string:
+            return Operand{value_t::make<StringValue>(static_cast<const StringValue&>(value).text()), nullptr, nullptr};
+
+        case ValueType::function:
+            break;
+    }
+
+    // refer to the nodes of an existing composition instead of wrapping it
+    if(const ComposedFunction *composition = static_cast<const FunctionValue&>(value).function.target<ComposedFunction>()){
+        return Operand{value_t(), nullptr, composition->root};
+    }
+
+    return Operand{value_t(), Ref<const FunctionValue>(&static_cast<const FunctionValue&>(value)), nullptr};
+}
+
+ComposedFunction::Operand ComposedFunction::Operand::from(const value_t &value){
+    if(value.type() == ValueType::function){
+        return from(value.object());
+    }
+
+    return Operand{value, nullptr, nullptr};
+}
+
+/**
+ *  Implimentation of nested structure ComposedFunction::Node
+**/
+
+ComposedFunction::Node::Node(Operation operation, Operand lhs, Operand rhs) : operation(operation), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+ComposedFunction::Node::~Node(){
+    // take ownership of children that would be destroyed along with this node, and destroy them one at a time
+    std::vector<std::shared_ptr<const Node>> pending;
+
+    const auto release = [&pending](Node &node){
+        for(Operand *operand : {&node.lhs, &node.rhs}){
+            if(operand->node && operand->node.use_count() == 1){
+                pending.push_back(std::move(operand->node));
+            }
+        }
+    };
+
+    release(*this);
+    while(!pending.empty()){
+        std::shared_ptr<const Node> node = std::move(pending.back());
+        pending.pop_back();
+
+        // nodes are only ever created by compose (never as const objects), so releasing their children is safe
+        release(const_cast<Node&>(*node));
+    }
+}
+
+const ComposedFunction::Program& ComposedFunction::Node::flatten() const {
+    std::call_once(flattened, [this](){
+        std::unordered_map<const FunctionValue*, std::uint32_t> leaves;
+        std::unordered_map<const Node*, std::uint32_t> steps;
+        std::vector<Step> ordered;
+
+        // depth first, post order, with an explicit stack so that long chains do not overflow the call stack
+        std::vector<std::pair<const Node*, bool /* children visited */>> stack = {{this, false}};
+
+        const auto source = [&](const Operand &operand) -> Source {
+            if(operand.node){
+                return Source{Source::Kind::step, steps.at(operand.node.get())};
+            }
+
+            if(operand.leaf){
+                const auto [entry, inserted] = leaves.try_emplace(operand.leaf.get(), program.leaves.size());
+                if(inserted){
+                    program.leaves.push_back(&operand.leaf->function);
+                }
+                return Source{Source::Kind::leaf, entry->second};
+            }
+
+            program.constants.push_back(&operand.constant);
+            return Source{Source::Kind::constant, static_cast<std::uint32_t>(program.constants.size() - 1)};
+        };
+
+        while(!stack.empty()){
+            const auto [node, visited] = stack.back();
+            stack.pop_back();
+
+            if(steps.count(node)){
+                continue;
+            }
+
+            if(!visited){
+                stack.emplace_back(node, true);
+                if(node->rhs.node){
+                    stack.emplace_back(node->rhs.node.get(), false);
+                }
+                if(node->lhs.node){
+                    stack.emplace_back(node->lhs.node.get(), false);
+                }
+                continue;
+            }
+
+            const Source lhs = source(node->lhs);
+            const Source rhs = node->operation == Operation::logical_not ? lhs : source(node->rhs);
+
+            steps.emplace(node, ordered.size());
+            ordered.push_back(Step{node->operation, lhs, rhs});
+        }
+
+        program.steps = std::move(ordered);
+    });
+
+    return program;
+}
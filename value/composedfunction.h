@@ -0,0 +1,158 @@
+/**
+ *      @file value/composedfunction.h
+ *      @brief defines ComposedFunction, the callable stored by function values built by operating on other functions (lazy operators)
+ *      @author Anastasia Sokol
+ *
+ *      operating on a function value (for example (+ f 2) or (* f g)) does not call anything, instead a new function is created
+ *      the result is represented as a DAG of operator nodes over shared leaf functions and constants
+ *          composing is constant time, the new node only refers to the nodes of its operands
+ *          the first call flattens the DAG into a list of steps (cached), every call then evaluates each distinct leaf once and applies the steps in a single loop
+**/
+
+#ifndef VALUE_COMPOSEDFUNCTION_H
+#define VALUE_COMPOSEDFUNCTION_H
+
+#include "value.hpp"    // defines Value and Value::value_t which are operated on
+
+#include <cstdint>      // defines std::uint8_t and std::uint32_t used to keep steps compact
+#include <memory>       // defines std::shared_ptr used to share nodes between compositions
+#include <mutex>        // defines std::once_flag used to flatten a composition only once
+#include <vector>       // defines std::vector used to store flattened steps
+
+struct FunctionValue;
+
+/**
+ *  @brief function_t target for a lazily composed function
+**/
+class ComposedFunction {
+    public:
+        /**
+         *  @brief operations that can be applied lazily, one for each value operator
+        **/
+        enum class Operation : std::uint8_t {
+            add,
+            subtract,
+            multiply,
+            divide,
+            greater,
+            less,
+            greater_equal,
+            less_equal,
+            logical_and,
+            logical_or,
+            logical_not
+        };
+
+        /**
+         *  @brief lazily apply a binary operation
+         *  @param operation to apply
+         *  @param lhs left hand side, the value (this) whose operator was called
+         *  @param rhs right hand side, at least one of lhs or rhs must be a function
+         *  @return function value that applies operation to the results of calling lhs and rhs (or to lhs and rhs directly if they are not functions)
+        **/
+        static Value::value_t compose(Operation, const Value&, const Value::value_t&);
+
+        /**
+         *  @brief lazily apply a unary operation (only Operation::logical_not)
+         *  @param operation to apply
+         *  @param operand function value to apply it to
+         *  @return function value that applies operation to the result of calling operand
+        **/
+        static Value::value_t compose(Operation, const Value&);
+
+        /**
+         *  @brief call every distinct leaf function with arguments once, then combine the results
+         *  @param arguments passed to every leaf function
+         *  @return result of root operation
+        **/
+        Value::value_t operator ()(Value::arguments_t) const;
+
+    private:
+        struct Node;
+
+        /**
+         *  @brief input to an operation, exactly one of constant (if not a function), leaf, or node is used
+        **/
+        struct Operand {
+            Value::value_t constant;                    // non-function operand
+            Ref<const FunctionValue> leaf;              // function operand that is not a composition
+            std::shared_ptr<const Node> node;           // function operand that is itself a composition
+
+            /**
+             *  @brief create operand from any value
+            **/
+            static Operand from(const Value&);
+
+            /**
+             *  @brief create operand from any value
+            **/
+            static Operand from(const Value::value_t&);
+        };
+
+        /**
+         *  @brief where a step reads an input from
+        **/
+        struct Source {
+            enum class Kind : std::uint8_t {
+                constant,           // index into Program::constants
+                leaf,               // index into Program::leaves (result of calling it)
+                step                // index into Program::steps (result of applying it)
+            } kind;
+            std::uint32_t index;
+        };
+
+        /**
+         *  @brief a single operation in a flattened composition
+        **/
+        struct Step {
+            Operation operation;
+            Source lhs;
+            Source rhs;             // unused for Operation::logical_not
+        };
+
+        /**
+         *  @brief flattened form of a composition, leaves are called in order and then steps are applied in order
+         *
+         *  only refers to values owned by the nodes of the composition, so it lives as long as the root node
+        **/
+        struct Program {
+            std::vector<const Value::function_t*> leaves;   // distinct leaf functions
+            std::vector<const Value::value_t*> constants;   // non-function operands
+            std::vector<Step> steps;                        // operations in dependency order, the last one is the result
+        };
+
+        /**
+         *  @brief a single lazy operation in the DAG
+        **/
+        struct Node {
+            Operation operation;
+            Operand lhs;
+            Operand rhs;
+
+            mutable std::once_flag flattened;   // guards program
+            mutable Program program;            // built on first call
+
+            Node(Operation, Operand, Operand);
+
+            /**
+             *  @brief release long chains of nodes without recursing once per node
+            **/
+            ~Node();
+
+            /**
+             *  @brief get flattened form of the DAG rooted at this node
+            **/
+            const Program& flatten() const;
+        };
+
+        std::shared_ptr<const Node> root;   // operation whose result is returned
+
+        ComposedFunction(std::shared_ptr<const Node>);
+
+        /**
+         *  @brief apply an operation to already evaluated inputs
+        **/
+        static Value::value_t apply(Operation, const Value::value_t&, const Value::value_t&);
+};
+
+#endif
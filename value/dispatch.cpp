@@ -0,0 +1,164 @@
+#include "dispatch.h"
+
+#include "numericvalue.h"   // defines NumericValue whose operators handle numeric left operands
+#include "booleanvalue.h"   // defines BooleanValue whose operators handle boolean left operands
+#include "stringvalue.h"    // defines StringValue whose operators handle string left operands
+#include "functionvalue.h"  // defines FunctionValue whose operators handle function left operands
+
+#include <utility>          // defines std::index_sequence used to generate the table
+
+using namespace dispatch;
+using value_t = Value::value_t;
+
+namespace {
+
+/**
+ *  @brief concrete value class of a ValueType
+**/
+template <ValueType type> struct Concrete;
+template <> struct Concrete<ValueType::numeric> { typedef NumericValue type; };
+template <> struct Concrete<ValueType::boolean> { typedef BooleanValue type; };
+template <> struct Concrete<ValueType::string> { typedef StringValue type; };
+template <> struct Concrete<ValueType::function> { typedef FunctionValue type; };
+
+/**
+ *  @brief call the operator of a concrete value class, without a virtual call
+**/
+template <Operation operation, typename concrete_t>
+value_t call(const concrete_t &value, const value_t &b){
+    if constexpr(operation == Operation::add){
+        return value.concrete_t::operator +(b);
+    } else if constexpr(operation == Operation::subtract){
+        return value.concrete_t::operator -(b);
+    } else if constexpr(operation == Operation::multiply){
+        return value.concrete_t::operator *(b);
+    } else if constexpr(operation == Operation::divide){
+        return value.concrete_t::operator /(b);
+    } else if constexpr(operation == Operation::greater){
+        return value.concrete_t::operator >(b);
+    } else if constexpr(operation == Operation::less){
+        return value.concrete_t::operator <(b);
+    } else if constexpr(operation == Operation::greater_equal){
+        return value.concrete_t::operator >=(b);
+    } else if constexpr(operation == Operation::less_equal){
+        return value.concrete_t::operator <=(b);
+    } else if constexpr(operation == Operation::logical_and){
+        return value.concrete_t::operator &&(b);
+    } else {
+        static_assert(operation == Operation::logical_or, "logical_not is not a binary operation");
+        return value.concrete_t::operator ||(b);
+    }
+}
+
+/**
+ *  @brief apply operation by calling the operator of the left type
+ *  @desc inline values are unpacked into a temporary NumericValue or BooleanValue, boxed values are used in place
+**/
+template <Operation operation, ValueType lhs>
+value_t member(const value_t &a, const value_t &b){
+    using concrete_t = typename Concrete<lhs>::type;
+
+    if constexpr(lhs == ValueType::numeric){
+        return call<operation>(NumericValue(a.numeric()), b);
+    } else if constexpr(lhs == ValueType::boolean){
+        return call<operation>(BooleanValue(a.boolean()), b);
+    } else {
+        return call<operation>(static_cast<const concrete_t&>(a.object()), b);
+    }
+}
+
+/**
+ *  @brief kernel of a single (operation, left type, right type), by default the operator of the left type
+**/
+template <Operation operation, ValueType lhs, ValueType rhs>
+struct Kernel {
+    static value_t apply(const value_t &a, const value_t &b){
+        return member<operation, lhs>(a, b);
+    }
+};
+
+/**
+ *  @brief numeric with numeric, the most common case by far, computed in place (same as NumericValue)
+**/
+template <Operation operation>
+struct Kernel<operation, ValueType::numeric, ValueType::numeric> {
+    static value_t apply(const value_t &a, const value_t &b){
+        const double x = a.numeric(), y = b.numeric();
+
+        if constexpr(operation == Operation::add){
+            return value_t(x + y);
+        } else if constexpr(operation == Operation::subtract){
+            return value_t(x - y);
+        } else if constexpr(operation == Operation::multiply){
+            return value_t(x * y);
+        } else if constexpr(operation == Operation::divide){
+            return value_t(x / y);
+        } else if constexpr(operation == Operation::greater){
+            return value_t(x > y);
+        } else if constexpr(operation == Operation::less){
+            return value_t(x < y);
+        } else if constexpr(operation == Operation::greater_equal){
+            return value_t(x >= y);
+        } else if constexpr(operation == Operation::less_equal){
+            return value_t(x <= y);
+        } else if constexpr(operation == Operation::logical_and){
+            return value_t(x && y);
+        } else {
+            return value_t(x || y);
+        }
+    }
+};
+
+/**
+ *  @brief boolean with boolean computed in place (same as BooleanValue), division is left to BooleanValue which rejects it
+**/
+template <Operation operation>
+struct Kernel<operation, ValueType::boolean, ValueType::boolean> {
+    static value_t apply(const value_t &a, const value_t &b){
+        const bool x = a.boolean(), y = b.boolean();
+
+        if constexpr(operation == Operation::add || operation == Operation::subtract){
+            // 1 bit modular arithmetic => xor
+            return value_t(x != y);
+        } else if constexpr(operation == Operation::multiply || operation == Operation::logical_and){
+            return value_t(x && y);
+        } else if constexpr(operation == Operation::divide){
+            return member<operation, ValueType::boolean>(a, b);
+        } else if constexpr(operation == Operation::greater){
+            return value_t(x > y);
+        } else if constexpr(operation == Operation::less){
+            return value_t(x < y);
+        } else if constexpr(operation == Operation::greater_equal){
+            return value_t(x >= y);
+        } else if constexpr(operation == Operation::less_equal){
+            return value_t(x <= y);
+        } else {
+            return value_t(x || y);
+        }
+    }
+};
+
+/**
+ *  @brief get the kernel at an index of the table
+**/
+template <std::size_t index>
+constexpr kernel_t entry(){
+    constexpr Operation operation = static_cast<Operation>(index / (types * types));
+    constexpr ValueType lhs = static_cast<ValueType>(index / types % types);
+    constexpr ValueType rhs = static_cast<ValueType>(index % types);
+    return &Kernel<operation, lhs, rhs>::apply;
+}
+
+/**
+ *  @brief build the table at compile time
+**/
+template <std::size_t... index>
+constexpr Table generate(std::index_sequence<index...>){
+    return Table{{entry<index>()...}};
+}
+
+} // end of anonymous namespace
+
+static_assert(static_cast<std::size_t>(ValueType::function) + 1 == types, "every ValueType needs a row in the table");
+
+const Table dispatch::table = generate(std::make_index_sequence<operations * types * types>());
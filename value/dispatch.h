@@ -0,0 +1,56 @@
+/**
+ *      @file value/dispatch.h
+ *      @brief defines the table binary operators on values are dispatched through in namespace dispatch
+ *      @author Anastasia Sokol
+ *
+ *      every (operation, left type, right type) has its own kernel, so applying an operator is a single indirect call picked by the types of both operands
+ *      instead of a virtual call on the left operand followed by a switch on the type of the right one
+ *      kernels are generated from templates (see dispatch.cpp), numeric and boolean pairs are computed in place and every other pair
+ *      calls the operator of the left type directly, which is where the rules for mixing types are written down
+**/
+
+#ifndef VALUE_DISPATCH_H
+#define VALUE_DISPATCH_H
+
+#include "value.hpp"            // defines Value::value_t which is operated on
+#include "composedfunction.h"   // defines ComposedFunction::Operation used to name operations
+
+#include <cstddef>              // defines std::size_t
+
+namespace dispatch {
+
+typedef ComposedFunction::Operation Operation;
+typedef Value::value_t (*kernel_t)(const Value::value_t&, const Value::value_t&);
+
+constexpr std::size_t operations = static_cast<std::size_t>(Operation::logical_not);   // binary operations, logical_not is unary and not in the table
+constexpr std::size_t types = 4;                                                        // number of ValueType
+
+/**
+ *  @brief every kernel, indexed by (operation * types + left type) * types + right type
+**/
+struct Table {
+    kernel_t kernels[operations * types * types];
+};
+
+extern const Table table;
+
+/**
+ *  @brief get the kernel applying operation to a left and a right value of the given types
+ *  @param operation to apply, must not be Operation::logical_not
+**/
+inline kernel_t kernel(Operation operation, ValueType lhs, ValueType rhs) noexcept {
+    return table.kernels[(static_cast<std::size_t>(operation) * types + static_cast<std::size_t>(lhs)) * types + static_cast<std::size_t>(rhs)];
+}
+
+/**
+ *  @brief apply a binary operation
+ *  @param operation to apply, must not be Operation::logical_not
+ *  @throws NotImplemented if the operation is not defined between the types of lhs and rhs
+**/
+inline Value::value_t apply(Operation operation, const Value::value_t &lhs, const Value::value_t &rhs){
+    return kernel(operation, lhs.type(), rhs.type())(lhs, rhs);
+}
+
+} // end of namespace dispatch
+
+#endif
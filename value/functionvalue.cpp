@@ -1,188 +1,64 @@
 #include "functionvalue.h"
 
-#include "numericvalue.h"
-#include "stringvalue.h"
-#include "booleanvalue.h"
-#include "notimplemented.hpp"
-
-#include <functional>
+#include "composedfunction.h"   // defines ComposedFunction used to lazily operate on functions
 
 using value_t = Value::value_t;
+using Operation = ComposedFunction::Operation;
 
-FunctionValue::FunctionValue(std::function<value_t(std::list<value_t>)> value) : Value(value) {}
+FunctionValue::FunctionValue(function_t value) : Value(ValueType::function), function(std::move(value)) {}
 
 value_t FunctionValue::operator +(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) + other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) + std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to add function value to a non-type");
+    // function of the same arguments whose result is the result of this + other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::add, *this, other);
 }
 
 value_t FunctionValue::operator -(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) - other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) - std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to subtract non-type from function value");
+    // function of the same arguments whose result is the result of this - other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::subtract, *this, other);
 }
 
 value_t FunctionValue::operator *(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) * other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) * std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to multiply function value and non-type");
+    // function of the same arguments whose result is the result of this * other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::multiply, *this, other);
 }
 
 value_t FunctionValue::operator /(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) / other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) / std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to divide function value by non-type");
+    // function of the same arguments whose result is the result of this / other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::divide, *this, other);
 }
 
-value_t FunctionValue::operator <(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) < std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
-    } else {
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) < other;
-        }));
-    }
+value_t FunctionValue::operator <(const value_t& other) const noexcept(false){
+    // function of the same arguments whose result is the result of this < other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::less, *this, other);
 }
 
-value_t FunctionValue::operator >(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) > std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
-    } else {
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) > other;
-        }));
-    }
+value_t FunctionValue::operator >(const value_t& other) const noexcept(false){
+    // function of the same arguments whose result is the result of this > other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::greater, *this, other);
 }
 
-value_t FunctionValue::operator <=(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) <= std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
-    } else {
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) <= other;
-        }));
-    }
+value_t FunctionValue::operator <=(const value_t& other) const noexcept(false){
+    // function of the same arguments whose result is the result of this <= other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::less_equal, *this, other);
 }
 
-value_t FunctionValue::operator >=(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) >= std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
-    } else {
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) >= other;
-        }));
-    }
+value_t FunctionValue::operator >=(const value_t& other) const noexcept(false){
+    // function of the same arguments whose result is the result of this >= other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::greater_equal, *this, other);
 }
 
 value_t FunctionValue::operator &&(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) && other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) && std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to 'and' function value and non-type");
+    // function of the same arguments whose result is the result of this && other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::logical_and, *this, other);
 }
 
 value_t FunctionValue::operator ||(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
-        case ValueType::string:
-        case ValueType::boolean:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) || other;
-            }));
-        
-        case ValueType::function:
-            // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments) || std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
-    }
-
-    throw NotImplemented("Unable to 'or' function value and non-type");
+    // function of the same arguments whose result is the result of this || other (or the result of other if it is a function)
+    return ComposedFunction::compose(Operation::logical_or, *this, other);
 }
 
 value_t FunctionValue::operator !() const noexcept(false){
-    return value_t(new FunctionValue([*this](std::list<value_t> arguments) -> value_t {
-        return !(std::get<std::function<value_t(std::list<value_t>)>>(this->value)(arguments));
-    }));
+    return ComposedFunction::compose(Operation::logical_not, *this);
 }
 
 FunctionValue::operator std::string() const {
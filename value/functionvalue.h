@@ -11,13 +11,18 @@
 
 /**
  *  @brief functional value designed to be used in a weakly typed manor with other value types
+ *
+ *  operators are lazy, they return a new function built by ComposedFunction which refers to (rather than copies) this function
+ *  because of that function values must always be owned by a Value::value_t
 **/
 struct FunctionValue : public Value {
+    function_t function;    // stored callable
+
     /**
      *  @brief construct a value object from a callable type
      *  @param value any callable type
     **/
-    FunctionValue(std::function<Value::value_t(std::list<Value::value_t>)>);
+    FunctionValue(function_t);
 
     /**
      *  @brief add a value of generic type to this 
@@ -95,4 +100,7 @@ struct FunctionValue : public Value {
     operator bool() const;
 };
 
+// size budget, see benchmark/footprint
+static_assert(sizeof(FunctionValue) <= 48, "boxed functions are allocated from the 48 byte blocks of the value pool");
+
 #endif
\ No newline at end of file
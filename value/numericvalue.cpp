@@ -2,48 +2,77 @@
 
 #include "stringvalue.h"
 #include "booleanvalue.h"
-#include "functionvalue.h"
+#include "composedfunction.h"
 #include "notimplemented.hpp"
 
-#include <iomanip>          // std::setprecision
+#include <algorithm>        // defines std::reverse used to repeat strings backwards
+#include <charconv>         // defines std::to_chars and std::from_chars
 #include <functional>       // defines std::function
+#include <stdexcept>        // defines std::invalid_argument and std::out_of_range thrown by parse
+#include <string>           // defines std::stod used for text parse does not handle itself
 
 #include <cmath>            // defines std::modf
 
 
 using value_t = Value::value_t;
 
-NumericValue::NumericValue(double value) : Value(value) {}
+NumericValue::NumericValue(double value) : Value(ValueType::numeric), number(value) {}
+
+std::size_t NumericValue::format(double value, char *buffer) noexcept {
+    double integral;
+    const int precision = std::modf(value, &integral) == 0.0 ? 0 : 6;
+
+    // fixed notation with an explicit precision prints exactly what printf("%.*f") would, which is what this has always printed
+    return std::to_chars(buffer, buffer + format_capacity, value, std::chars_format::fixed, precision).ptr - buffer;
+}
+
+double NumericValue::parse(std::string_view text) noexcept(false) {
+    double value;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if(error == std::errc() && end == text.data() + text.size()){
+        return value;
+    }
+
+    if(error == std::errc::result_out_of_range){
+        throw std::out_of_range("numeric out of range: " + std::string(text));
+    }
+
+    // leading whitespace, a leading +, hexadecimal, or trailing text, which std::stod has its own rules for
+    return std::stod(std::string(text));
+}
 
 value_t NumericValue::operator +(const value_t& other) const noexcept(false){
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric addition
-            return value_t(new NumericValue(std::get<double>(value) + std::get<double>(other->value)));
+            return value_t(number + other.numeric());
         
         case ValueType::string:
             // convert this to string first, then add as strings
-            return value_t(new StringValue((std::string)*this + (std::string)*other));
+            {
+                char buffer[format_capacity];
+                std::string text(buffer, format(number, buffer));
+                return value_t::make<StringValue>(text.append(other.string()));
+            }
         
         case ValueType::boolean:
             // 1 bit modular arithmetic is the same as xor
-            return value_t(new BooleanValue((bool)*this ^ (bool)*other));
+            return value_t((bool)*this != (bool)other);
         
         case ValueType::function:
             // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this + std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::add, *this, other);
     }
 
     throw NotImplemented("Unable to add numeric value to a non-type");
 }
 
 value_t NumericValue::operator -(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric subtraction
-            return value_t(new NumericValue(std::get<double>(value) - std::get<double>(other->value)));
+            return value_t(number - other.numeric());
         
         case ValueType::string:
             // does not make logical sense
@@ -51,65 +80,62 @@ value_t NumericValue::operator -(const value_t& other) const noexcept(false) {
         
         case ValueType::boolean:
             // 1 bit modular subtraction
-            return value_t(new BooleanValue((bool)*other ? !(bool)*this : (bool)*this));
+            return value_t((bool)other ? !(bool)*this : (bool)*this);
         
         case ValueType::function:
             // create new function that is the result of the current value of this minus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this - std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::subtract, *this, other);
     }
 
     throw NotImplemented("Unable to subtract non-type from numeric");
 }
 
 value_t NumericValue::operator *(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric multiplication
-            return value_t(new NumericValue(std::get<double>(value) * std::get<double>(other->value)));
+            return value_t(number * other.numeric());
         
         case ValueType::string:
             // string appearing n times in a row, if negative then reversed
             {
-                ssize_t n = std::get<double>(value);
+                ssize_t n = number;
 
                 bool reverse = n < 0 ? n = -n : false;
 
+                const std::string &text = other.string();
                 std::string temporary;
                 
-                temporary.reserve(n * std::get<std::string>(other->value).length());
+                temporary.reserve(n * text.length());
                 
                 for(ssize_t i = 0; i < n; ++i){
-                    temporary += std::get<std::string>(other->value);
+                    temporary += text;
                 }
 
                 if(reverse){
                     std::reverse(temporary.begin(), temporary.end());
                 }
 
-                return value_t(new StringValue(std::move(temporary)));
+                return value_t::make<StringValue>(std::move(temporary));
             }
 
         case ValueType::boolean:
             // boolean multiplication is the same as the 'and' operation
-            return value_t(new BooleanValue((bool)*this && (bool)*other));
+            return value_t((bool)*this && (bool)other);
         
         case ValueType::function:
             // create new function that is the result of the current value of this multiplied by the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this * std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::multiply, *this, other);
     }
 
     throw NotImplemented("Unable to multiply numeric value by a non-type");
 }
 
 value_t NumericValue::operator /(const value_t& other) const noexcept(false){
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric division
-            return value_t(new NumericValue(std::get<double>(value) / std::get<double>(other->value)));
+            return value_t(number / other.numeric());
         
         case ValueType::string:
             // no logical definition
@@ -121,19 +147,17 @@ value_t NumericValue::operator /(const value_t& other) const noexcept(false){
 
         case ValueType::function:
             // create new function that is the result of the current value of this divided by the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this / std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::divide, *this, other);
     }
 
     throw NotImplemented("Unable to divide numeric value by a non-type");
 }
 
 value_t NumericValue::operator >(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric comparison
-            return value_t(new BooleanValue(std::get<double>(value) > std::get<double>(other->value)));
+            return value_t(number > other.numeric());
         
         case ValueType::string:
             // no real logical definition
@@ -141,23 +165,21 @@ value_t NumericValue::operator >(const value_t& other) const noexcept(false) {
         
         case ValueType::boolean:
             // check if resulting booleans are the same
-            return value_t(new BooleanValue((bool)*this > (bool)*this));
+            return value_t((bool)*this > (bool)*this);
         
         case ValueType::function:
             // create new function that checks if result is less than current value
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this > std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::greater, *this, other);
     }
 
     throw NotImplemented("Unable to compare numeric value and a non-type");
 }
 
 value_t NumericValue::operator <(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric comparison
-            return value_t(new BooleanValue(std::get<double>(value) < std::get<double>(other->value)));
+            return value_t(number < other.numeric());
         
         case ValueType::string:
             // no real logical definition
@@ -165,23 +187,21 @@ value_t NumericValue::operator <(const value_t& other) const noexcept(false) {
         
         case ValueType::boolean:
             // check if resulting booleans are the same
-            return value_t(new BooleanValue((bool)*this < (bool)*other));
+            return value_t((bool)*this < (bool)other);
         
         case ValueType::function:
             // create new function that checks if result is less than current value
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this < std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::less, *this, other);
     }
 
     throw NotImplemented("Unable to compare numeric value and a non-type");
 }
 
 value_t NumericValue::operator >=(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric comparison
-            return value_t(new BooleanValue(std::get<double>(value) >= std::get<double>(other->value)));
+            return value_t(number >= other.numeric());
         
         case ValueType::string:
             // no real logical definition
@@ -189,23 +209,21 @@ value_t NumericValue::operator >=(const value_t& other) const noexcept(false) {
         
         case ValueType::boolean:
             // check if resulting booleans are the same
-            return value_t(new BooleanValue((bool)*this >= (bool)*other));
+            return value_t((bool)*this >= (bool)other);
         
         case ValueType::function:
             // create new function that checks if result is less than current value
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this >= std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::greater_equal, *this, other);
     }
 
     throw NotImplemented("Unable to compare numeric value and a non-type");
 }
 
 value_t NumericValue::operator <=(const value_t& other) const noexcept(false) {
-    switch(other->type){
+    switch(other.type()){
         case ValueType::numeric:
             // normal numeric comparison
-            return value_t(new BooleanValue(std::get<double>(value) <= std::get<double>(other->value)));
+            return value_t(number <= other.numeric());
         
         case ValueType::string:
             // no real logical definition
@@ -213,57 +231,45 @@ value_t NumericValue::operator <=(const value_t& other) const noexcept(false) {
         
         case ValueType::boolean:
             // check if resulting booleans are the same
-            return value_t(new BooleanValue((bool)*this <= (bool)*other));
+            return value_t((bool)*this <= (bool)other);
         
         case ValueType::function:
             // create new function that checks if result is less than current value
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this <= std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::less_equal, *this, other);
     }
 
     throw NotImplemented("Unable to compare numeric value and a non-type");
 }
 
 value_t NumericValue::operator &&(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
+    if(other.type() == ValueType::function){
         // if function delay as always
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return *this && std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
+        return ComposedFunction::compose(ComposedFunction::Operation::logical_and, *this, other);
     } else {
         // otherwise cast to booleans then do normal and
-        return value_t(new BooleanValue((bool)*this && (bool)*other));
+        return value_t((bool)*this && (bool)other);
     }
 }
 
 value_t NumericValue::operator ||(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
+    if(other.type() == ValueType::function){
         // if function delay as always
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return *this || std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
+        return ComposedFunction::compose(ComposedFunction::Operation::logical_or, *this, other);
     } else {
         // otherwise cast to booleans then do normal or
-        return value_t(new BooleanValue((bool)*this || (bool)*other));
+        return value_t((bool)*this || (bool)other);
     }
 }
 
 value_t NumericValue::operator !() const noexcept(false) {
-    return value_t(new BooleanValue(!(bool)*this));
+    return value_t(!(bool)*this);
 }
 
 NumericValue::operator std::string() const {
-    double intg;
-    if(std::modf(std::get<double>(value), &intg) == 0.0){
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(0) << intg;
-        return ss.str();
-    } else {
-        return std::to_string(std::get<double>(value));
-    }
+    char buffer[format_capacity];
+    return std::string(buffer, format(number, buffer));
 }
 
 NumericValue::operator bool() const {
-    return std::get<double>(value);
+    return number;
 }
\ No newline at end of file
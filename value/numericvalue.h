@@ -9,13 +9,37 @@
 
 #include "value.hpp"    // defines base class Value
 
+#include <cstddef>      // defines std::size_t
+#include <string_view>  // defines std::string_view used to parse numerics
+
 /**
  *  @brief represents a numeric value in a weakly typed way with other value types 
 **/
 struct NumericValue : public Value {
+    static constexpr std::size_t format_capacity = 320;    // characters format may write, enough for the largest whole double (309 digits) and a sign
+
+    double number;  // stored value
+
+    /**
+     *  @brief write the text of a numeric into buffer, without allocating
+     *  @desc whole numbers are written without a decimal point, anything else with six decimal places (the same as std::to_string)
+     *  @param value to format
+     *  @param buffer to write into, at least format_capacity characters long (not null terminated)
+     *  @return number of characters written
+    **/
+    static std::size_t format(double, char*) noexcept;
+
+    /**
+     *  @brief read a numeric from text, without allocating
+     *  @desc accepts what std::stod accepts for plain decimal text (which is everything the lexer and readnumeric produce), anything else is handed to std::stod
+     *  @param text to read
+     *  @throws std::invalid_argument if text is not a number, std::out_of_range if it does not fit in a double (same as std::stod)
+     *  @return value of text
+    **/
+    static double parse(std::string_view) noexcept(false);
+
     /**
      *  @brief construct a numeric value with given value
-     *  @desc calls Value double overloaded constructor 
     **/
     NumericValue(double value);
 
@@ -95,4 +119,7 @@ struct NumericValue : public Value {
     operator bool() const;
 };
 
+// size budget, see benchmark/footprint
+static_assert(sizeof(NumericValue) <= 24, "a numeric is only ever a temporary, it should not be larger than the base and its double");
+
 #endif
\ No newline at end of file
@@ -2,28 +2,88 @@
 
 #include "numericvalue.h"
 #include "booleanvalue.h"
-#include "functionvalue.h"
+#include "composedfunction.h"
 #include "notimplemented.hpp"
 
 #include <functional>
+#include <unordered_map>
+#include <utility>
 
 using value_t = Value::value_t;
 
-StringValue::StringValue(const std::string &value) : Value(value) {}
+StringValue::StringValue(const std::string &value) : Value(ValueType::string), length(0), flat(value) {}
+StringValue::StringValue(std::shared_ptr<Buffer> buffer, std::size_t length) : Value(ValueType::string), buffer(std::move(buffer)), length(length) {}
+
+value_t StringValue::literal(std::string_view text){
+    // keys are views of the text of the values they map to, which lives as long as the pool
+    static std::mutex lock;
+    static std::unordered_map<std::string_view, value_t> literals;
+
+    std::lock_guard<std::mutex> guard(lock);
+    const auto location = literals.find(text);
+    if(location != literals.end()){
+        return location->second;
+    }
+
+    value_t value = value_t::make<StringValue>(std::string(text));
+    literals.emplace(value.string(), value);
+    return value;
+}
+
+const std::string& StringValue::text() const {
+    if(!buffer){
+        return flat;
+    }
+
+    std::call_once(copied, [this](){
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        flat.assign(buffer->text, 0, length);
+    });
+    return flat;
+}
+
+std::size_t StringValue::size() const {
+    return buffer ? length : flat.size();
+}
+
+value_t StringValue::append(std::string_view suffix) const {
+    if(buffer){
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        if(buffer->text.size() == length){
+            // nothing was added after this string yet, so the buffer can grow in place
+            buffer->text.append(suffix);
+            return value_t::make<StringValue>(buffer, buffer->text.size());
+        }
+    }
+
+    // start a new buffer, reserving room so that the strings built from the result keep growing it in place
+    const std::string &prefix = text();
+    auto grown = std::make_shared<Buffer>();
+    grown->text.reserve(2 * (prefix.size() + suffix.size()));
+    grown->text.append(prefix).append(suffix);
+
+    const std::size_t size = grown->text.size();
+    return value_t::make<StringValue>(std::move(grown), size);
+}
 
 value_t StringValue::operator +(const value_t& other) const noexcept(false){
-    switch(other->type){
-        case ValueType::numeric:
+    switch(other.type()){
         case ValueType::string:
+            return append(other.string());
+
+        case ValueType::numeric:
+            {
+                char buffer[NumericValue::format_capacity];
+                return append(std::string_view(buffer, NumericValue::format(other.numeric(), buffer)));
+            }
+
         case ValueType::boolean:
             // convert to string then add
-            return value_t(new StringValue((std::string)*this + (std::string)*other));
+            return append((std::string)other);
 
         case ValueType::function:
             // create new function that is the result of the current value of this plus the result of the given function
-            return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-                return *this + std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-            }));
+            return ComposedFunction::compose(ComposedFunction::Operation::add, *this, other);
     }
 
     throw NotImplemented("Unable to add non-type to string");
@@ -42,69 +102,70 @@ value_t StringValue::operator /(const value_t&) const noexcept(false){
 }
 
 value_t StringValue::operator <(const value_t& other) const noexcept(false) {
-    if(other->type != ValueType::string){
+    if(other.type() != ValueType::string){
         throw NotImplemented("Can only compare strings to other strings");
     }
 
-    return value_t(new BooleanValue((std::string)*this < (std::string)*other));
+    return value_t(text() < other.string());
 }
 
 value_t StringValue::operator >(const value_t& other) const noexcept(false) {
-    if(other->type != ValueType::string){
+    if(other.type() != ValueType::string){
         throw NotImplemented("Can only compare strings to other strings");
     }
 
-    return value_t(new BooleanValue((std::string)*this > (std::string)*other));
+    return value_t(text() > other.string());
 }
 
 value_t StringValue::operator <=(const value_t& other) const noexcept(false) {
-    if(other->type != ValueType::string){
+    if(other.type() != ValueType::string){
         throw NotImplemented("Can only compare strings to other strings");
     }
 
-    return value_t(new BooleanValue((std::string)*this <= (std::string)*other));
+    return value_t(text() <= other.string());
 }
 
 value_t StringValue::operator >=(const value_t& other) const noexcept(false) {
-    if(other->type != ValueType::string){
+    if(other.type() != ValueType::string){
         throw NotImplemented("Can only compare strings to other strings");
     }
 
-    return value_t(new BooleanValue((std::string)*this >= (std::string)*other));
+    return value_t(text() >= other.string());
 }
 
 value_t StringValue::operator &&(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
+    if(other.type() == ValueType::function){
         // if function delay as always
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return *this && std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
+        return ComposedFunction::compose(ComposedFunction::Operation::logical_and, *this, other);
     } else {
         // otherwise cast to booleans then do normal and
-        return value_t(new BooleanValue((bool)*this && (bool)*other));
+        return value_t((bool)*this && (bool)other);
     }
 }
 
 value_t StringValue::operator ||(const value_t& other) const noexcept(false) {
-    if(other->type == ValueType::function){
+    if(other.type() == ValueType::function){
         // if function delay as always
-        return value_t(new FunctionValue([*this, other /* captures both by value */](std::list<value_t> arguments) -> value_t {
-            return *this || std::get<std::function<value_t(std::list<value_t>)>>(other->value)(arguments);
-        }));
+        return ComposedFunction::compose(ComposedFunction::Operation::logical_or, *this, other);
     } else {
         // otherwise cast to booleans then do normal and
-        return value_t(new BooleanValue((bool)*this || (bool)*other));
+        return value_t((bool)*this || (bool)other);
     }
 }
 
 value_t StringValue::operator !() const noexcept(false) {
-    return value_t(new BooleanValue(!(bool)*this));
+    return value_t(!(bool)*this);
 }
 
 StringValue::operator std::string() const {
-    return std::get<std::string>(this->value);
+    if(buffer){
+        // copy straight out of the buffer, there is no need to keep a copy of a string that is only printed
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        return buffer->text.substr(0, length);
+    }
+    return flat;
 }
 
 StringValue::operator bool() const {
-    return (std::string)*this == "";
+    return size() == 0;
 }
\ No newline at end of file
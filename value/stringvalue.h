@@ -2,6 +2,9 @@
  *      @file value/stringvalue.h
  *      @brief defines interface for StringValue subclass
  *      @author Anastasia Sokol
+ *
+ *      strings built by adding to a string share one growing buffer (see StringValue::Buffer) so a chain like (+ s1 s2 s3 ...) or a loop adding
+ *      to the same string copies every character once instead of once per step, the string is only copied out of the buffer when it is needed whole
 **/
 
 #ifndef VALUE_STRINGVALUE_H
@@ -9,16 +12,50 @@
 
 #include "value.hpp"    // defines Value base class
 
+#include <cstddef>      // defines std::size_t
+#include <memory>       // defines std::shared_ptr used to share buffers between strings
+#include <mutex>        // defines std::mutex and std::once_flag so that workers of pmap and preduce can share strings
+#include <string>       // defines std::string
+#include <string_view>  // defines std::string_view used to add text to a string
+
 /**
  *  @brief represents a string value in a weakly typed way with other value types 
 **/
 struct StringValue : public Value {
     /**
      *  @brief construct a string value with given value
-     *  @desc calls Value std::string overloaded constructor 
     **/
     StringValue(const std::string &value);
 
+    private:
+        struct Buffer;
+
+    public:
+    /**
+     *  @brief create string as the first length characters of buffer
+     *  @desc only usable by StringValue itself (Buffer is private), it is public so that it can be constructed in the value pool
+    **/
+    StringValue(std::shared_ptr<Buffer>, std::size_t);
+
+    /**
+     *  @brief get the value of a string literal
+     *  @desc literals are interned, every literal with the same text shares one string value (strings never change, so sharing is safe)
+     *        thread safe, so that expressions can be built on one thread while others run (see parser::PipelinedExpressionStream)
+     *  @param text of literal
+    **/
+    static value_t literal(std::string_view);
+
+    /**
+     *  @brief get the whole string
+     *  @desc a string that is part of a shared buffer is copied out of it the first time, the copy is kept for every later call
+    **/
+    const std::string& text() const;
+
+    /**
+     *  @brief get length of string without copying it out of a shared buffer
+    **/
+    std::size_t size() const;
+
     /**
      *  @brief add a value of generic type to this 
      *  @desc see documentation (if existant) for how string values interact with other values
@@ -93,6 +130,29 @@ struct StringValue : public Value {
      *  @brief tests if the string is empty
     **/
     operator bool() const;
+
+    private:
+        /**
+         *  @brief text shared by a string and every string built by adding to it, each of them is a prefix of text
+        **/
+        struct Buffer {
+            std::mutex lock;    // guards text, strings in different threads may add to the same buffer
+            std::string text;   // only ever grows
+        };
+
+        std::shared_ptr<Buffer> buffer;         // buffer this string is a prefix of, or nullptr if the string is stored in flat
+        std::size_t length;                     // length of prefix of buffer
+        mutable std::once_flag copied;          // set once text copied the prefix into flat
+        mutable std::string flat;               // whole string, if buffer is set only once it was needed
+
+        /**
+         *  @brief create a string that is this string followed by suffix
+         *  @desc if nothing was added to the buffer after this string, suffix is added to the buffer in place, otherwise this string is copied into a new buffer
+        **/
+        value_t append(std::string_view) const;
 };
 
+// size budget, see benchmark/footprint
+static_assert(sizeof(StringValue) <= 80, "boxed strings are allocated from the 80 byte blocks of the value pool");
+
 #endif
\ No newline at end of file
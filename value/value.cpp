@@ -1,11 +1,13 @@
 #include "value.hpp"
 
+#include "numericvalue.h"       // defines NumericValue used to operate on inline numeric values
+#include "booleanvalue.h"       // defines BooleanValue used to operate on inline boolean values
+#include "stringvalue.h"        // defines StringValue which may be boxed
+#include "functionvalue.h"      // defines FunctionValue which may be boxed
+#include "dispatch.h"           // defines dispatch::apply which binary operators go through
 #include "notimplemented.hpp"   // defines NotImplemented exception, used heavily
 
-Value::Value(const double value) : value(value), type(ValueType::numeric) {}
-Value::Value(const std::string &value) : value(value), type(ValueType::string) {}
-Value::Value(const bool value) : value(value), type(ValueType::boolean) {}
-Value::Value(const std::function<value_t(std::list<value_t>)> &value) : value(value), type(ValueType::function) {}
+Value::Value(ValueType type) : type(type) {}
 
 Value::value_t Value::operator +(const value_t&) const noexcept(false) {
     throw NotImplemented("Addition is not implemented for void type");
@@ -57,4 +59,77 @@ Value::operator std::string() const {
 
 Value::operator bool() const {
     throw NotImplemented("Casting to boolean is not implemented for void type");
-}
\ No newline at end of file
+}
+
+/**
+ *  Implimentation of nested class Value::value_t
+**/
+
+Value::value_t::value_t(Value *value) noexcept : tag(value->type) {
+    payload.boxed = value;
+    value->retain();
+}
+
+/**
+ *  @brief call operation with the concrete value held by handle
+ *  @desc inline values are unpacked into a temporary NumericValue or BooleanValue, boxed values are used in place
+ *  @param handle to unpack
+ *  @param operation callable accepting any const Value subclass
+ *  @return result of operation
+**/
+template <typename operation_t>
+static auto unpack(const Value::value_t &handle, operation_t operation){
+    switch(handle.type()){
+        case ValueType::numeric:
+            return operation(NumericValue(handle.numeric()));
+
+        case ValueType::boolean:
+            return operation(BooleanValue(handle.boolean()));
+
+        case ValueType::string:
+        case ValueType::function:
+            break;
+    }
+
+    return operation(handle.object());
+}
+
+const std::string& Value::value_t::string() const {
+    return static_cast<const StringValue&>(*payload.boxed).text();
+}
+
+const Value::function_t& Value::value_t::function() const {
+    return static_cast<const FunctionValue&>(*payload.boxed).function;
+}
+
+Value::value_t::operator bool() const {
+    switch(tag){
+        case ValueType::numeric:
+            return payload.numeric;
+
+        case ValueType::boolean:
+            return payload.boolean;
+
+        case ValueType::string:
+        case ValueType::function:
+            break;
+    }
+
+    return (bool)*payload.boxed;
+}
+
+Value::value_t::operator std::string() const {
+    return unpack(*this, [](const Value &value) -> std::string { return (std::string)value; });
+}
+
+Value::value_t operator +(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::add, a, b); }
+Value::value_t operator -(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::subtract, a, b); }
+Value::value_t operator *(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::multiply, a, b); }
+Value::value_t operator /(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::divide, a, b); }
+Value::value_t operator >(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::greater, a, b); }
+Value::value_t operator <(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::less, a, b); }
+Value::value_t operator >=(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::greater_equal, a, b); }
+Value::value_t operator <=(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::less_equal, a, b); }
+Value::value_t operator &&(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::logical_and, a, b); }
+Value::value_t operator ||(const Value::value_t& a, const Value::value_t& b){ return dispatch::apply(dispatch::Operation::logical_or, a, b); }
+Value::value_t operator !(const Value::value_t& a){ return unpack(a, [](const Value &value){ return !value; }); }
\ No newline at end of file
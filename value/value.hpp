@@ -8,47 +8,58 @@
 #define DATATYPE_VALUE_H
 
 #include "valuetype.h"  // defines ValueType used to represent weak type of object
+#include "valuepool.h"  // defines pool::allocate and pool::deallocate used to allocate boxed values
+#include "../datatype/refcounted.hpp"   // defines RefCounted and Ref used to share boxed values
 
+#include <cstddef>      // defines std::size_t used to count arguments
 #include <functional>   // defines std::function used to perform magic
-#include <list>         // defines std::list used to hold a collection of values
-#include <variant>      // defines std::varient a type checked version of a union
-#include <memory>       // defines std::shared_ptr used to automatically manage lifetime of values
-#include <string>       // defines std::string, needed because std::string must be a complete type to be used in std::variant
+#include <type_traits>  // defines std::enable_if_t, std::is_convertible_v, and std::is_same_v used to accept any contiguous container of arguments and to tag boxed values
+#include <utility>      // defines std::forward used to construct boxed values in place
+#include <string>       // defines std::string which every value converts to
+
+struct StringValue;     // forward declare boxed value types so that Value::value_t can take ownership of them
+struct FunctionValue;
 
 /**
  *  @brief base class for weakly typed value implimention
  * 
  *  calling an operation on base class will result in a NotImplemented exception
+ *  string and function values live on the heap as Value objects, numeric and boolean values are only ever constructed as temporaries (see Value::value_t)
+ *  the base only holds the type, each subclass stores its own payload, so a temporary NumericValue is no larger than it has to be
 **/
-struct Value {
-    typedef std::shared_ptr<Value> value_t; // allows for easy dynamic memory management
-    
-    std::variant<double, std::string, bool, std::function<value_t(std::list<value_t>)>> value;  // stores generic value of object
+struct Value : public RefCounted {
+    class value_t;                                              // handle to a value of any type, see below
+    class arguments_t;                                          // view of the arguments of a call, see below
+    typedef std::function<value_t(arguments_t)> function_t;     // callable stored by function values
+
     ValueType type; // references what kind of value is being stored at any given time
 
     /**
-     *  @brief extend to initialize value with double
-     *  @param value to initialize value to
+     *  @brief extend to initialize type
+     *  @param type of subclass
     **/
-    Value(const double value);
+    explicit Value(ValueType type);
 
     /**
-     *  @brief extend to initialize value with string
-     *  @param value to initialize value to
+     *  @brief values are deleted through handles to the base class
     **/
-    Value(const std::string &value);
+    virtual ~Value() = default;
 
     /**
-     *  @brief extend to initialize value with boolean
-     *  @param value to initialize value to
+     *  @brief boxed values are allocated from the value pool (see value/valuepool.h)
+     *  @desc values are deleted through the virtual destructor, so the size passed to delete is always the size of the type that was allocated
     **/
-    Value(const bool value);
+    static inline void* operator new(std::size_t size){
+        return size <= pool::largest ? pool::allocate(size) : ::operator new(size);
+    }
 
-    /**
-     *  @brief extend to initialize value with function
-     *  @param value to initialize value to
-    **/
-    Value(const std::function<value_t(std::list<value_t>)> &value);
+    static inline void operator delete(void *block, std::size_t size) noexcept {
+        if(size <= pool::largest){
+            pool::deallocate(block, size);
+        } else {
+            ::operator delete(block);
+        }
+    }
 
     /**
      *  @brief add other to value
@@ -137,18 +148,213 @@ struct Value {
     virtual operator bool() const;
 };
 
-// allow for operations on Value::value_t as if simply of type Value
-
-inline Value::value_t operator +(const Value::value_t& a, const Value::value_t& b){ return *a + b; }
-inline Value::value_t operator -(const Value::value_t& a, const Value::value_t& b){ return *a - b; }
-inline Value::value_t operator *(const Value::value_t& a, const Value::value_t& b){ return *a * b; }
-inline Value::value_t operator /(const Value::value_t& a, const Value::value_t& b){ return *a / b; }
-inline Value::value_t operator >(const Value::value_t& a, const Value::value_t& b){ return *a > b; }
-inline Value::value_t operator <(const Value::value_t& a, const Value::value_t& b){ return *a < b; }
-inline Value::value_t operator >=(const Value::value_t& a, const Value::value_t& b){ return *a >= b; }
-inline Value::value_t operator <=(const Value::value_t& a, const Value::value_t& b){ return *a <= b; }
-inline Value::value_t operator &&(const Value::value_t& a, const Value::value_t& b){ return *a && b; }
-inline Value::value_t operator ||(const Value::value_t& a, const Value::value_t& b){ return *a || b; }
-inline Value::value_t operator !(const Value::value_t& a){ return !(*a); }
+/**
+ *  @brief handle to a weakly typed value
+ *
+ *  numeric and boolean values are stored inline so that arithmetic and comparisons never allocate
+ *  string and function values are boxed, the handle shares ownership of a heap allocated StringValue or FunctionValue
+ *  a handle is a payload and a tag, 16 bytes, so arguments, bindings, and vm stack slots of any type take a quarter of a cache line
+**/
+class Value::value_t {
+    private:
+        union Payload {
+            double numeric;
+            bool boolean;
+            Value *boxed;               // counted reference (see RefCounted) to a string or function value
+        } payload;                      // storage for the held value
+        ValueType tag;                  // type of value held by handle
+
+        /**
+         *  @brief take shared ownership of a boxed value
+        **/
+        explicit value_t(Value*) noexcept;
+
+        /**
+         *  @brief true if payload.boxed is used
+        **/
+        inline bool boxed() const noexcept {
+            return tag == ValueType::string || tag == ValueType::function;
+        }
+
+    public:
+        /**
+         *  @brief default construct to the boolean false
+        **/
+        inline value_t() noexcept : tag(ValueType::boolean) { payload.boolean = false; }
+
+        /**
+         *  @brief create inline numeric value
+        **/
+        inline value_t(const double value) noexcept : tag(ValueType::numeric) { payload.numeric = value; }
+
+        /**
+         *  @brief create inline boolean value
+        **/
+        inline value_t(const bool value) noexcept : tag(ValueType::boolean) { payload.boolean = value; }
+
+        /**
+         *  @brief create a boxed string or function value
+         *  @desc the value and its reference count are a single block from the value pool (see value/valuepool.h)
+         *  @param arguments passed to the constructor of boxed_t
+        **/
+        template <typename boxed_t, typename... argument_t>
+        static value_t make(argument_t&&... arguments){
+            static_assert(std::is_same_v<boxed_t, StringValue> || std::is_same_v<boxed_t, FunctionValue>, "only string and function values are boxed");
+            return value_t(static_cast<Value*>(new boxed_t(std::forward<argument_t>(arguments)...)));
+        }
+
+        /**
+         *  @brief any pointer would silently convert to bool, boxed values are created with make
+        **/
+        template <typename pointer_t>
+        value_t(pointer_t*) = delete;
+
+        inline value_t(const value_t &other) noexcept : payload(other.payload), tag(other.tag) {
+            if(boxed()){
+                payload.boxed->retain();
+            }
+        }
+
+        /**
+         *  @brief take over the value of other, leaving it the boolean false
+        **/
+        inline value_t(value_t &&other) noexcept : payload(other.payload), tag(other.tag) {
+            other.tag = ValueType::boolean;
+            other.payload.boolean = false;
+        }
+
+        inline value_t& operator =(const value_t &other) noexcept {
+            // the old value is released last, its destructor may lead back here
+            value_t previous(std::move(*this));
+            payload = other.payload;
+            tag = other.tag;
+            if(boxed()){
+                payload.boxed->retain();
+            }
+            return *this;
+        }
+
+        inline value_t& operator =(value_t &&other) noexcept {
+            if(this != &other){
+                value_t previous(std::move(*this));
+                payload = other.payload;
+                tag = other.tag;
+                other.tag = ValueType::boolean;
+                other.payload.boolean = false;
+            }
+            return *this;
+        }
+
+        inline ~value_t(){
+            if(boxed()){
+                payload.boxed->release();
+            }
+        }
+
+        /**
+         *  @brief get type of held value
+        **/
+        inline ValueType type() const noexcept {
+            return tag;
+        }
+
+        /**
+         *  @brief get held double, only valid if type() is ValueType::numeric
+        **/
+        inline double numeric() const noexcept {
+            return payload.numeric;
+        }
+
+        /**
+         *  @brief get held boolean, only valid if type() is ValueType::boolean
+        **/
+        inline bool boolean() const noexcept {
+            return payload.boolean;
+        }
+
+        /**
+         *  @brief get held string, only valid if type() is ValueType::string
+        **/
+        const std::string& string() const;
+
+        /**
+         *  @brief get held callable, only valid if type() is ValueType::function
+        **/
+        const function_t& function() const;
+
+        /**
+         *  @brief get heap allocated object, only valid for string and function values
+        **/
+        inline const Value& object() const noexcept {
+            return *payload.boxed;
+        }
+
+        /**
+         *  @brief get truthiness of held value (not whether or not the handle is empty, handles are never empty)
+        **/
+        explicit operator bool() const;
+
+        /**
+         *  @brief convert held value to string
+        **/
+        explicit operator std::string() const;
+};
+
+// size budgets, see benchmark/footprint
+static_assert(sizeof(Value) <= 16, "Value should only hold a vtable pointer, a reference count, and a type");
+static_assert(sizeof(Value::value_t) <= 16, "Value::value_t should only hold a payload and a tag");
+
+/**
+ *  @brief read only view of the arguments passed to a function value
+ *
+ *  the caller owns the arguments (usually in a SmallVector on its own stack) and they stay valid until the call returns
+ *  a function that needs to keep arguments after returning must copy them
+**/
+class Value::arguments_t {
+    private:
+        const value_t *first;   // first argument
+        std::size_t count;      // number of arguments
+
+    public:
+        /**
+         *  @brief no arguments
+        **/
+        inline arguments_t() noexcept : first(nullptr), count(0) {}
+
+        /**
+         *  @brief view count arguments starting at first
+        **/
+        inline arguments_t(const value_t *first, std::size_t count) noexcept : first(first), count(count) {}
+
+        /**
+         *  @brief view every element of a contiguous container of values (for example SmallVector or std::vector)
+        **/
+        template <typename container_t, typename = std::enable_if_t<std::is_convertible_v<decltype(std::declval<const container_t&>().data()), const value_t*>>>
+        inline arguments_t(const container_t &values) noexcept : first(values.data()), count(values.size()) {}
+
+        inline std::size_t size() const noexcept { return count; }
+        inline bool empty() const noexcept { return !count; }
+
+        inline const value_t& operator [](std::size_t index) const noexcept { return first[index]; }
+        inline const value_t& front() const noexcept { return first[0]; }
+        inline const value_t& back() const noexcept { return first[count - 1]; }
+
+        inline const value_t* begin() const noexcept { return first; }
+        inline const value_t* end() const noexcept { return first + count; }
+};
+
+// allow for operations on Value::value_t as if simply of type Value, dispatched on the type of the left hand side
+
+Value::value_t operator +(const Value::value_t&, const Value::value_t&);
+Value::value_t operator -(const Value::value_t&, const Value::value_t&);
+Value::value_t operator *(const Value::value_t&, const Value::value_t&);
+Value::value_t operator /(const Value::value_t&, const Value::value_t&);
+Value::value_t operator >(const Value::value_t&, const Value::value_t&);
+Value::value_t operator <(const Value::value_t&, const Value::value_t&);
+Value::value_t operator >=(const Value::value_t&, const Value::value_t&);
+Value::value_t operator <=(const Value::value_t&, const Value::value_t&);
+Value::value_t operator &&(const Value::value_t&, const Value::value_t&);
+Value::value_t operator ||(const Value::value_t&, const Value::value_t&);
+Value::value_t operator !(const Value::value_t&);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "valuepool.h"
+
+#include <atomic>   // defines std::atomic used so that statistics can be read while other threads count
+#include <mutex>    // defines std::mutex used to guard blocks and counters left by threads that exited
+
+using namespace pool;
+
+namespace {
+
+constexpr std::size_t chunk_size = 64;              // blocks taken from the heap at once
+constexpr std::size_t spill_limit = 4 * chunk_size;  // free blocks of a class a thread keeps, half of them are spilled once there are more
+constexpr std::size_t refill_size = 2 * chunk_size;  // most blocks a thread takes from the shared list at once
+
+/**
+ *  @brief a free block, the link is stored in the block itself
+**/
+struct Block {
+    Block *next;
+};
+
+/**
+ *  @brief counters of one size class on one thread
+ *  @desc only ever written by that thread, they are atomic only so that statistics can read them from another thread
+**/
+struct Counters {
+    std::atomic<std::uint64_t> allocations;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> refills;
+    std::atomic<std::uint64_t> chunks;
+    std::atomic<std::uint64_t> spills;
+};
+
+/**
+ *  @brief free lists and counters of one thread
+ *  @desc trivially destructible, so it can still be used while the thread exits (after that blocks go through Shared, see Registration)
+**/
+struct Cache {
+    Block *free[classes];           // free blocks of every size class
+    std::size_t count[classes];     // length of every free list
+    Counters counters[classes];     // use of every size class
+    Cache *previous, *next;         // neighbours in the list of running threads
+    bool registered;                // true once the thread was added to the list of running threads
+    bool retired;                   // true once the thread is exiting and its free lists were handed over
+};
+
+/**
+ *  @brief everything threads share, only used on the slow paths
+**/
+struct Shared {
+    std::mutex lock;                    // guards everything below
+    Block *free[classes] = {};          // blocks spilled by threads or left by threads that exited, taken in batches by threads that run out
+    Statistics retired[classes];        // use of every size class by threads that exited
+    Cache *threads = nullptr;           // caches of running threads
+};
+
+thread_local Cache cache;
+
+Shared& shared(){
+    // never destroyed, values may still be freed while static objects are destroyed
+    static Shared *instance = new Shared();
+    return *instance;
+}
+
+/**
+ *  @brief adds the cache of a thread to the list of running threads, and hands over its blocks and counters once the thread exits
+**/
+struct Registration {
+    Registration(){
+        Shared &pool = shared();
+        std::lock_guard<std::mutex> guard(pool.lock);
+
+        cache.next = pool.threads;
+        if(pool.threads){
+            pool.threads->previous = &cache;
+        }
+        pool.threads = &cache;
+        cache.registered = true;
+    }
+
+    ~Registration(){
+        Shared &pool = shared();
+        std::lock_guard<std::mutex> guard(pool.lock);
+
+        for(std::size_t index = 0; index < classes; ++index){
+            if(Block *first = cache.free[index]){
+                Block *last = first;
+                while(last->next){
+                    last = last->next;
+                }
+                last->next = pool.free[index];
+                pool.free[index] = first;
+                cache.free[index] = nullptr;
+                cache.count[index] = 0;
+            }
+
+            const Counters &counters = cache.counters[index];
+            Statistics &retired = pool.retired[index];
+            retired.allocations += counters.allocations.load(std::memory_order_relaxed);
+            retired.hits += counters.hits.load(std::memory_order_relaxed);
+            retired.refills += counters.refills.load(std::memory_order_relaxed);
+            retired.chunks += counters.chunks.load(std::memory_order_relaxed);
+            retired.spills += counters.spills.load(std::memory_order_relaxed);
+        }
+
+        (cache.previous ? cache.previous->next : pool.threads) = cache.next;
+        if(cache.next){
+            cache.next->previous = cache.previous;
+        }
+        cache.retired = true;
+    }
+};
+
+/**
+ *  @brief get the cache of the calling thread
+**/
+inline Cache& local(){
+    if(!cache.registered){
+        static thread_local Registration registration;
+        (void)registration;
+    }
+    return cache;
+}
+
+/**
+ *  @brief add one to a counter only written by the calling thread, without a locked instruction
+**/
+inline void bump(std::atomic<std::uint64_t> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/**
+ *  @brief take a chunk of new blocks from the heap
+ *  @param index of size class
+ *  @return first block, linked to the rest
+**/
+Block* chunk(std::size_t index){
+    const std::size_t size = (index + 1) * granularity;
+    char *memory = static_cast<char*>(::operator new(size * chunk_size));
+
+    Block *next = nullptr;
+    for(std::size_t block = chunk_size; block; --block){
+        next = new(memory + (block - 1) * size) Block{next};
+    }
+    return next;
+}
+
+} // end of anonymous namespace
+
+Statistics pool::statistics(std::size_t index){
+    Shared &pool = shared();
+    std::lock_guard<std::mutex> guard(pool.lock);
+
+    Statistics result = pool.retired[index];
+    for(const Cache *thread = pool.threads; thread; thread = thread->next){
+        const Counters &counters = thread->counters[index];
+        result.allocations += counters.allocations.load(std::memory_order_relaxed);
+        result.hits += counters.hits.load(std::memory_order_relaxed);
+        result.refills += counters.refills.load(std::memory_order_relaxed);
+        result.chunks += counters.chunks.load(std::memory_order_relaxed);
+        result.spills += counters.spills.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void* pool::allocate(std::size_t size) noexcept(false) {
+    const std::size_t index = (size - 1) / granularity;
+    Cache &thread = local();
+
+    if(thread.retired){
+        // the thread is exiting, which is rare enough that locking does not matter
+        Shared &pool = shared();
+        std::lock_guard<std::mutex> guard(pool.lock);
+
+        Statistics &retired = pool.retired[index];
+        ++retired.allocations;
+        if(!pool.free[index]){
+            pool.free[index] = chunk(index);
+            ++retired.chunks;
+        }
+
+        Block *block = pool.free[index];
+        pool.free[index] = block->next;
+        return block;
+    }
+
+    Counters &counters = thread.counters[index];
+    Block *&free = thread.free[index];
+    bump(counters.allocations);
+
+    if(free){
+        bump(counters.hits);
+    } else {
+        {
+            Shared &pool = shared();
+            std::lock_guard<std::mutex> guard(pool.lock);
+
+            // only take a batch, a thread that took everything would keep blocks others then take new chunks for
+            if(Block *first = pool.free[index]){
+                Block *last = first;
+                std::size_t taken = 1;
+                while(taken < refill_size && last->next){
+                    last = last->next;
+                    ++taken;
+                }
+                pool.free[index] = last->next;
+                last->next = nullptr;
+
+                free = first;
+                thread.count[index] = taken;
+            }
+        }
+
+        if(free){
+            bump(counters.refills);
+        } else {
+            free = chunk(index);
+            thread.count[index] = chunk_size;
+            bump(counters.chunks);
+        }
+    }
+
+    Block *block = free;
+    free = block->next;
+    --thread.count[index];
+    return block;
+}
+
+void pool::deallocate(void *memory, std::size_t size) noexcept {
+    const std::size_t index = (size - 1) / granularity;
+    Cache &thread = local();
+
+    if(thread.retired){
+        Shared &pool = shared();
+        std::lock_guard<std::mutex> guard(pool.lock);
+        pool.free[index] = new(memory) Block{pool.free[index]};
+        return;
+    }
+
+    Block *&free = thread.free[index];
+    free = new(memory) Block{free};
+    if(++thread.count[index] <= spill_limit){
+        return;
+    }
+
+    // keep the most recently freed half, which is most likely still cached, and hand the rest to threads that run out
+    Block *last = free;
+    for(std::size_t kept = 1; kept < spill_limit / 2; ++kept){
+        last = last->next;
+    }
+    Block *first = last->next;
+    last->next = nullptr;
+
+    last = first;
+    while(last->next){
+        last = last->next;
+    }
+
+    thread.count[index] = spill_limit / 2;
+    bump(thread.counters[index].spills);
+
+    Shared &pool = shared();
+    std::lock_guard<std::mutex> guard(pool.lock);
+    last->next = pool.free[index];
+    pool.free[index] = first;
+}
@@ -0,0 +1,57 @@
+/**
+ *      @file value/valuepool.h
+ *      @brief defines the allocator string and function values are boxed with in namespace pool
+ *      @author Anastasia Sokol
+ *
+ *      boxed values are short lived and only come in a few sizes, so blocks are kept on a free list per size class instead of going back to the heap
+ *      each thread has its own free lists (no locking), a block can be freed on any thread and is then reused by that thread
+ *      a thread that frees more blocks than it allocates (for example the caller of pmap, which frees what workers allocated) spills the excess into a shared list
+ *      other threads refill from, so blocks do not pile up on one thread while others take new ones from the heap
+ *      memory is taken from the heap a chunk of blocks at a time and is never given back, so the pool only grows to the most values alive at once
+**/
+
+#ifndef VALUE_VALUEPOOL_H
+#define VALUE_VALUEPOOL_H
+
+#include <cstddef>      // defines std::size_t
+#include <cstdint>      // defines std::uint64_t used for statistics
+
+namespace pool {
+
+constexpr std::size_t granularity = 16;                 // block sizes are multiples of granularity, which is also the alignment of every block
+constexpr std::size_t classes = 16;                     // number of size classes
+constexpr std::size_t largest = granularity * classes;  // largest block served from the pool, anything larger goes to the heap
+
+/**
+ *  @brief how a size class was used by every thread, printed by --pool-stats
+**/
+struct Statistics {
+    std::uint64_t allocations = 0;  // blocks handed out
+    std::uint64_t hits = 0;         // blocks taken from the free list of the allocating thread
+    std::uint64_t refills = 0;      // times a free list was refilled with blocks spilled by other threads or left by threads that exited
+    std::uint64_t spills = 0;       // times a thread had too many free blocks and spilled some into the shared list
+    std::uint64_t chunks = 0;       // times a chunk of new blocks was taken from the heap
+};
+
+/**
+ *  @brief get statistics of a size class
+ *  @param index of size class, blocks of the class are (index + 1) * granularity bytes
+**/
+Statistics statistics(std::size_t);
+
+/**
+ *  @brief get a block of at least size bytes
+ *  @param size in bytes, at most largest
+**/
+void* allocate(std::size_t) noexcept(false);
+
+/**
+ *  @brief give a block back to the pool
+ *  @param block returned by allocate
+ *  @param size passed to allocate
+**/
+void deallocate(void*, std::size_t) noexcept;
+
+} // end of namespace pool
+
+#endif
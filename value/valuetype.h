@@ -7,9 +7,10 @@
 #ifndef VALUE_VALUETYPE_H
 #define VALUE_VALUETYPE_H
 
+#include <cstdint>  // defines std::uint8_t so that the type fits in the padding of Value and Value::value_t
 #include <string>   // defines std::string
 
-enum class ValueType {
+enum class ValueType : std::uint8_t {
     numeric,
     string,
     boolean,
@@ -0,0 +1,70 @@
+/**
+ *      @file vm/chunk.h
+ *      @brief defines the bytecode format (OpCode, Instruction, and Chunk) produced by vm::Compiler and run by vm::Machine
+ *      @author Anastasia Sokol
+**/
+
+#ifndef VM_CHUNK_H
+#define VM_CHUNK_H
+
+#include "../value/value.hpp"               // defines Value::value_t used to store constants
+#include "../datatype/token.hpp"            // defines Token::TokenPosition used to report errors from inside bytecode
+#include "../datatype/programstate.h"       // defines ProgramState::slot_t used to refer to references
+
+#include <atomic>                           // defines std::atomic used to mark results of memoized lambdas stale
+#include <cstdint>                          // defines std::uint8_t and std::uint32_t used to keep instructions compact
+#include <memory>                           // defines std::shared_ptr used to share compiled lambda bodies between closures
+#include <vector>                           // defines std::vector used to store linear code and pools
+
+namespace vm {
+
+/**
+ *  @brief every operation understood by vm::Machine
+ *
+ *  the machine is stack based, every instruction pops its inputs from and pushes its result onto the value stack
+**/
+enum class OpCode : std::uint8_t {
+    push_constant,      // push Chunk::constants[operand]
+    load_reference,     // push value of reference in slot operand
+    define,             // set reference in slot operand to top of stack (value is left on stack)
+    self,               // pop value, if function call it with no arguments, push result
+    operate,            // pop two values, push result of applying dispatch::Operation(operand)
+    negate,             // pop one value, push boolean negation
+    expect_function,    // check that top of stack is a function (without popping it)
+    call,               // pop operand arguments and a function, push result of calling function
+    jump,               // continue execution at code[operand]
+    jump_if_false,      // pop value, continue execution at code[operand] if value is not truthy
+    make_lambda,        // push a new function value for the body stored in Chunk::lambdas[operand]
+    ret,                // leave the current chunk, top of stack is the result
+    tail_self,          // same as self, but only emitted when the result is returned immediately (a lambda called here reuses the current frame and scope)
+    tail_call           // same as call, but only emitted when the result is returned immediately (a lambda called here reuses the current frame and scope)
+};
+
+/**
+ *  @brief a single bytecode instruction
+ *
+ *  the meaning of operand depends on the operation, see vm::OpCode
+**/
+struct Instruction {
+    OpCode code;            // operation to perform
+    std::uint32_t operand;  // index into one of the chunk pools, jump target, or argument count
+};
+
+/**
+ *  @brief linear bytecode for a single top level expression or lambda body
+**/
+struct Chunk {
+    typedef std::shared_ptr<const Chunk> chunk_t;   // compiled chunks are immutable and shared between closures
+
+    std::vector<Instruction> code;                  // instructions executed in order
+    std::vector<Token::TokenPosition> positions;    // position of the expression that emitted each instruction, same length as code
+    std::vector<Value::value_t> constants;          // literal values used by push_constant
+    std::vector<chunk_t> lambdas;                   // bodies of lambda expressions used by make_lambda
+    std::vector<ProgramState::slot_t> parameters;   // parameter slots if this chunk is a lambda body (empty otherwise)
+    bool memoize = false;                           // if true closures of this lambda body cache their results (see vm::Closure::cache)
+    std::shared_ptr<const std::atomic<bool>> stale; // once true memoized closures stop caching (see LambdaExpression::define), nullptr if never
+};
+
+} // end of namespace vm
+
+#endif
@@ -0,0 +1,66 @@
+#include "compiler.h"
+
+using namespace vm;
+
+Compiler::Compiler() : chunk(new Chunk()) {}
+
+Chunk::chunk_t Compiler::compile(const Expression &expression){
+    Compiler compiler;
+    expression.compile(compiler);
+    return compiler.finish(expression.position);
+}
+
+Chunk::chunk_t Compiler::compile(const std::vector<ProgramState::slot_t> &parameters, const Expression &body, bool memoize, std::shared_ptr<const std::atomic<bool>> stale){
+    Compiler compiler;
+    compiler.chunk->parameters = parameters;
+    compiler.chunk->memoize = memoize;
+    compiler.chunk->stale = std::move(stale);
+    body.compile(compiler);
+    return compiler.finish(body.position);
+}
+
+std::size_t Compiler::emit(OpCode code, std::uint32_t operand, const Token::TokenPosition &position){
+    chunk->code.push_back(Instruction{code, operand});
+    chunk->positions.push_back(position);
+    return chunk->code.size() - 1;
+}
+
+void Compiler::patch(std::size_t instruction){
+    chunk->code[instruction].operand = chunk->code.size();
+}
+
+std::uint32_t Compiler::constant(Value::value_t value){
+    chunk->constants.push_back(std::move(value));
+    return chunk->constants.size() - 1;
+}
+
+std::uint32_t Compiler::lambda(const std::vector<ProgramState::slot_t> &parameters, const Expression &body, bool memoize, std::shared_ptr<const std::atomic<bool>> stale){
+    chunk->lambdas.push_back(compile(parameters, body, memoize, std::move(stale)));
+    return chunk->lambdas.size() - 1;
+}
+
+Chunk::chunk_t Compiler::finish(const Token::TokenPosition &position){
+    emit(OpCode::ret, 0, position);
+
+    // calls whose value is returned straight away can reuse the frame of the caller
+    for(std::size_t i = 0; i + 1 < chunk->code.size(); ++i){
+        Instruction &instruction = chunk->code[i];
+        if(instruction.code == OpCode::call && returns(i + 1)){
+            instruction.code = OpCode::tail_call;
+        } else if(instruction.code == OpCode::self && returns(i + 1)){
+            instruction.code = OpCode::tail_self;
+        }
+    }
+
+    chunk->code.shrink_to_fit();
+    chunk->positions.shrink_to_fit();
+    return chunk;
+}
+
+bool Compiler::returns(std::size_t instruction) const {
+    // jumps only ever go forward, so this always terminates
+    while(chunk->code[instruction].code == OpCode::jump){
+        instruction = chunk->code[instruction].operand;
+    }
+    return chunk->code[instruction].code == OpCode::ret;
+}
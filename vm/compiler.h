@@ -0,0 +1,90 @@
+/**
+ *      @file vm/compiler.h
+ *      @brief defines vm::Compiler which lowers an expression tree into a bytecode vm::Chunk
+ *      @author Anastasia Sokol
+ *
+ *      each Expression subclass knows how to compile itself (see Expression::compile) using the emit helpers provided here
+**/
+
+#ifndef VM_COMPILER_H
+#define VM_COMPILER_H
+
+#include "chunk.h"                          // defines vm::Chunk, vm::Instruction, and vm::OpCode
+#include "../expression/expression.hpp"     // defines Expression which is the input to the compiler
+
+namespace vm {
+
+/**
+ *  @brief builds a single vm::Chunk from an expression tree
+**/
+class Compiler {
+    private:
+        std::shared_ptr<Chunk> chunk;   // chunk currently being written
+
+    public:
+        /**
+         *  @brief compile a top level expression
+         *  @param expression to compile
+         *  @return chunk that evaluates expression and returns its value
+        **/
+        static Chunk::chunk_t compile(const Expression&);
+
+        /**
+         *  @brief compile the body of a lambda expression
+         *  @param parameters slots the lambda binds before running body
+         *  @param body expression of lambda
+         *  @param memoize see Chunk::memoize
+         *  @param stale see Chunk::stale
+         *  @return chunk that evaluates body and returns its value
+        **/
+        static Chunk::chunk_t compile(const std::vector<ProgramState::slot_t>&, const Expression&, bool = false, std::shared_ptr<const std::atomic<bool>> = nullptr);
+
+        /**
+         *  @brief append an instruction to the chunk
+         *  @param code operation to append
+         *  @param operand of operation
+         *  @param position of the expression responsible for the instruction
+         *  @return index of the new instruction (used to patch jumps)
+        **/
+        std::size_t emit(OpCode, std::uint32_t, const Token::TokenPosition&);
+
+        /**
+         *  @brief point a previously emitted jump at the next instruction to be emitted
+         *  @param instruction index returned by emit
+        **/
+        void patch(std::size_t);
+
+        /**
+         *  @brief add a value to the constant pool
+         *  @return index of constant
+        **/
+        std::uint32_t constant(Value::value_t);
+
+        /**
+         *  @brief compile a lambda body and add it to the lambda pool
+         *  @param parameters of lambda
+         *  @param body of lambda
+         *  @param memoize see Chunk::memoize
+         *  @param stale see Chunk::stale
+         *  @return index of lambda
+        **/
+        std::uint32_t lambda(const std::vector<ProgramState::slot_t>&, const Expression&, bool = false, std::shared_ptr<const std::atomic<bool>> = nullptr);
+
+    private:
+        Compiler();
+
+        /**
+         *  @brief finish the chunk with a ret instruction, mark calls in tail position, and hand it off
+        **/
+        Chunk::chunk_t finish(const Token::TokenPosition&);
+
+        /**
+         *  @brief check if execution starting at instruction reaches ret without doing anything else (following jumps)
+         *  @param instruction index to start at
+        **/
+        bool returns(std::size_t) const;
+};
+
+} // end of namespace vm
+
+#endif
@@ -0,0 +1,242 @@
+#include "machine.h"
+
+#include "../expression/invalidexpression.hpp"      // defines InvalidExpression for reporting calls to non-functions
+#include "../value/dispatch.h"                     // defines dispatch::apply used by the operate instruction
+#include "../value/functionvalue.h"                 // defines FunctionValue used to wrap closures
+#include "../value/notimplemented.hpp"              // defines NotImplemented for reporting incorrect number of arguments
+
+#include "../datatype/smallvector.hpp"              // defines SmallVector used to hold the arguments of calls to native functions
+
+using namespace vm;
+
+using value_t = Value::value_t;
+using function_t = Value::function_t;
+
+Value::value_t Closure::operator ()(Value::arguments_t arguments) const {
+    // on worker threads (see frstd::pmap) this runs on the machine of the worker, whatever machine created the closure
+    return (Machine::current ? Machine::current : machine)->call(*this, arguments);
+}
+
+thread_local Machine *Machine::current = nullptr;
+
+Machine::Machine(ProgramState &state) : state(state) {}
+
+Value::value_t Machine::run(Chunk::chunk_t chunk){
+    const std::size_t depth = frames.size();
+    const std::size_t height = stack.size();
+
+    try {
+        frames.push_back(Frame{std::move(chunk), 0, false, false});
+        return execute(depth);
+    } catch(...) {
+        // leave machine and program state as they were before the failed run
+        for(; frames.size() > depth; frames.pop_back()){
+            if(frames.back().scoped){ state.pop(); }
+            if(frames.back().memoized){ pending.pop_back(); }
+        }
+        stack.resize(height);
+        throw;
+    }
+}
+
+Value::value_t Machine::call(const Closure &closure, Value::arguments_t arguments){
+    const std::size_t depth = frames.size();
+    const std::size_t height = stack.size();
+
+    try {
+        for(const auto &argument : arguments){
+            stack.push_back(argument);
+        }
+
+        if(!enter(closure, arguments.size())){
+            value_t result = std::move(stack.back());
+            stack.pop_back();
+            return result;
+        }
+        return execute(depth);
+    } catch(...) {
+        for(; frames.size() > depth; frames.pop_back()){
+            if(frames.back().scoped){ state.pop(); }
+            if(frames.back().memoized){ pending.pop_back(); }
+        }
+        stack.resize(height);
+        throw;
+    }
+}
+
+bool Machine::enter(const Closure &closure, std::size_t count, bool tail){
+    const std::vector<ProgramState::slot_t> &parameters = closure.body->parameters;
+
+    if(count != parameters.size()){
+        throw NotImplemented("Attempt to call function with incorrect number of parameters");
+    }
+
+    const std::size_t base = stack.size() - count;
+
+    // a call in tail position replaces the frame that would store its result, so only other calls are cached
+    frstd::MemoCache::key_t key;
+    const bool cached = closure.cache && !tail && closure.cache->key(Value::arguments_t(stack.data() + base, count), key);
+    if(cached){
+        value_t result;
+        if(closure.cache->find(key, result)){
+            stack.resize(base);
+            stack.push_back(std::move(result));
+            return false;
+        }
+    }
+
+    if(!tail){
+        state.push();
+    }
+
+    for(std::size_t i = 0; i < count; ++i){
+        state.set(parameters[i], std::move(stack[base + i]));
+    }
+    stack.resize(base);
+
+    if(tail){
+        // the caller is finished, parameters of the callee were bound over its own in the same scope, and its result is the result of the caller
+        frames.back() = Frame{closure.body, 0, true, frames.back().memoized};
+    } else {
+        frames.push_back(Frame{closure.body, 0, true, cached});
+        if(cached){
+            pending.push_back(Pending{closure.cache, std::move(key)});
+        }
+    }
+    return true;
+}
+
+Value::value_t Machine::execute(std::size_t depth){
+    // cache the current frame, must be reloaded whenever frames changes
+    const Chunk *chunk = frames.back().chunk.get();
+    std::size_t ip = frames.back().ip;
+
+    while(true){
+        const Instruction instruction = chunk->code[ip++];
+
+        switch(instruction.code){
+            case OpCode::push_constant:
+                stack.push_back(chunk->constants[instruction.operand]);
+                break;
+
+            case OpCode::load_reference:
+                stack.push_back(state.get(instruction.operand));
+                break;
+
+            case OpCode::define:
+                state.set(instruction.operand, stack.back());
+                break;
+
+            case OpCode::operate:
+                {
+                    const value_t right = std::move(stack.back());
+                    stack.pop_back();
+                    stack.back() = dispatch::apply((dispatch::Operation)instruction.operand, stack.back(), right);
+                }
+                break;
+
+            case OpCode::negate:
+                stack.back() = !stack.back();
+                break;
+
+            case OpCode::jump:
+                ip = instruction.operand;
+                break;
+
+            case OpCode::jump_if_false:
+                {
+                    const bool condition = (bool)stack.back();
+                    stack.pop_back();
+                    if(!condition){
+                        ip = instruction.operand;
+                    }
+                }
+                break;
+
+            case OpCode::make_lambda:
+                if(const Chunk::chunk_t &body = chunk->lambdas[instruction.operand]; body->memoize){
+                    stack.push_back(value_t::make<FunctionValue>(Closure{this, body, std::make_shared<frstd::MemoCache>(frstd::MemoCache::default_capacity, body->stale)}));
+                } else {
+                    stack.push_back(value_t::make<FunctionValue>(Closure{this, body, nullptr}));
+                }
+                break;
+
+            case OpCode::expect_function:
+                if(stack.back().type() != ValueType::function){
+                    throw InvalidExpression(chunk->positions[ip - 1], "Expected function at start of function expression, got " + to_string(stack.back().type()));
+                }
+                break;
+
+            case OpCode::self:
+            case OpCode::tail_self:
+                if(stack.back().type() != ValueType::function){
+                    // pure values are passed through
+                    break;
+                }
+                [[fallthrough]];
+
+            case OpCode::call:
+            case OpCode::tail_call:
+                {
+                    // self expressions are calls with no arguments
+                    const bool self = instruction.code == OpCode::self || instruction.code == OpCode::tail_self;
+                    const std::size_t count = self ? 0 : instruction.operand;
+
+                    // top level chunks have no scope to reuse
+                    const bool tail = (instruction.code == OpCode::tail_call || instruction.code == OpCode::tail_self) && frames.back().scoped;
+
+                    const value_t function = std::move(stack[stack.size() - count - 1]);
+                    const function_t &callable = function.function();
+
+                    if(const Closure *closure = callable.target<Closure>()){
+                        // lambda created by this machine, run in place instead of recursing
+                        frames.back().ip = ip;
+                        if(enter(*closure, count, tail)){
+                            stack.pop_back();
+
+                            chunk = frames.back().chunk.get();
+                            ip = 0;
+                        } else {
+                            // cached result is on top of the stack, above the function
+                            stack.erase(stack.end() - 2);
+                        }
+                    } else {
+                        // moved off of the stack first, the callable may run this machine again (which may reallocate the stack)
+                        SmallVector<value_t, 4> arguments;
+                        for(auto argument = stack.end() - count; argument != stack.end(); ++argument){
+                            arguments.push_back(std::move(*argument));
+                        }
+                        stack.resize(stack.size() - count - 1);
+                        stack.push_back(callable(arguments));
+                    }
+                }
+                break;
+
+            case OpCode::ret:
+                {
+                    value_t result = std::move(stack.back());
+                    stack.pop_back();
+
+                    if(frames.back().scoped){
+                        state.pop();
+                    }
+                    if(frames.back().memoized){
+                        Pending &call = pending.back();
+                        call.cache->insert(std::move(call.key), result);
+                        pending.pop_back();
+                    }
+                    frames.pop_back();
+
+                    if(frames.size() == depth){
+                        return result;
+                    }
+
+                    stack.push_back(std::move(result));
+
+                    chunk = frames.back().chunk.get();
+                    ip = frames.back().ip;
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ *      @file vm/machine.h
+ *      @brief defines vm::Machine, a stack based virtual machine that runs chunks produced by vm::Compiler
+ *      @author Anastasia Sokol
+ *
+ *      calls between lambdas created by the machine do not recurse on the native stack, instead a frame is pushed onto Machine::frames
+ *      calls in tail position of a lambda (OpCode::tail_call and OpCode::tail_self) reuse the frame and scope of the caller, so tail recursion runs in constant memory
+ *      functions from anywhere else (standard library, lazy function operators) are called through their std::function as usual
+ *      calls of memoized lambdas are looked up before a frame is pushed and stored when it returns, so they do not recurse on the native stack either
+**/
+
+#ifndef VM_MACHINE_H
+#define VM_MACHINE_H
+
+#include "chunk.h"                          // defines vm::Chunk which is what the machine runs
+#include "../datatype/programstate.h"       // defines ProgramState used to store references
+#include "../utility/memoize.h"             // defines frstd::MemoCache used by closures of memoized lambdas
+
+#include <memory>                           // defines std::shared_ptr used to share caches between copies of a closure
+
+#include <vector>                           // defines std::vector used for the value and frame stacks
+
+namespace vm {
+
+class Machine;
+
+/**
+ *  @brief callable stored inside of FunctionValue for every lambda created by the machine
+ *  @desc the machine recognizes closures (through std::function::target) so that it can call them without native recursion
+**/
+struct Closure {
+    Machine *machine;                           // machine that created the closure, used when called from outside of the machine unless Machine::current is set
+    Chunk::chunk_t body;                        // compiled body of lambda, parameters are stored in body->parameters
+    std::shared_ptr<frstd::MemoCache> cache;    // results of calls if body->memoize, otherwise nullptr
+
+    /**
+     *  @brief call lambda from outside of the machine
+     *  @param arguments to bind to parameters
+     *  @return result of evaluating body
+    **/
+    Value::value_t operator ()(Value::arguments_t) const;
+};
+
+/**
+ *  @brief executes bytecode chunks against a program state
+**/
+class Machine {
+    private:
+        /**
+         *  @brief position inside of a chunk that is currently being executed
+        **/
+        struct Frame {
+            Chunk::chunk_t chunk;   // chunk being executed (owned so that temporary closures stay alive)
+            std::size_t ip;         // index of next instruction to execute
+            bool scoped;            // true if a scope was pushed onto the program state for this frame
+            bool memoized;          // true if the value returned is stored as the result of Machine::pending.back()
+        };
+
+        /**
+         *  @brief call of a memoized closure whose result is stored once its frame returns
+        **/
+        struct Pending {
+            std::shared_ptr<frstd::MemoCache> cache;    // cache of the closure called
+            frstd::MemoCache::key_t key;                // arguments of the call
+        };
+
+        ProgramState &state;                // state shared by all code run on this machine
+        std::vector<Value::value_t> stack;  // value stack
+        std::vector<Frame> frames;          // call stack
+        std::vector<Pending> pending;       // calls of memoized frames, innermost last
+
+        /**
+         *  @brief run instructions until the frame stack shrinks back down to depth
+         *  @param depth number of frames that existed before the frame to run was pushed
+         *  @return value returned by the outermost frame
+        **/
+        Value::value_t execute(std::size_t);
+
+        /**
+         *  @brief push a frame for a closure whose arguments are the top count values of the stack
+         *  @desc pops the arguments, pushes a new scope (unless tail), and binds parameters
+         *        if the closure is memoized and the result of the call is cached, the arguments are replaced by the result instead
+         *  @param closure to enter
+         *  @param count number of arguments on the stack
+         *  @param tail if true replace the current frame and bind parameters in its scope instead of pushing new ones
+         *  @throws NotImplemented if count does not match the number of parameters
+         *  @return false if the cached result was pushed instead of a frame
+        **/
+        bool enter(const Closure&, std::size_t, bool tail = false);
+
+    public:
+        /**
+         *  @brief machine closures called from outside of a machine on this thread run on, instead of the machine that created them (unless nullptr)
+         *  @desc set by main to its only machine, and by frstd::pmap and frstd::preduce to the machine of each worker
+        **/
+        static thread_local Machine *current;
+
+        /**
+         *  @brief create machine that operates on state
+         *  @param state of program, must outlive the machine and any closures it creates
+        **/
+        Machine(ProgramState&);
+
+        /**
+         *  @brief run a top level chunk
+         *  @param chunk to run
+         *  @return value of chunk
+        **/
+        Value::value_t run(Chunk::chunk_t);
+
+        /**
+         *  @brief call a closure with arguments (used when entering the machine from a std::function)
+         *  @return value returned by closure
+        **/
+        Value::value_t call(const Closure&, Value::arguments_t);
+};
+
+} // end of namespace vm
+
+#endif